@@ -6,14 +6,41 @@
 #define DEBUG_TOOL "gf2"
 #define COMPILER_TOOL "clang"
 
+// The modules that are shared between tristrip and the benchmarks.
+#define MODULE_SOURCES                                                                        \
+    "./src/points.c", "./src/transform.c", "./src/mesh.c", "./src/strip.c", "./src/labels.c", \
+    "./src/profiler.c", "./src/geometry.c", "./src/raster.c", "./src/stripify.c",             \
+    "./src/vcache.c", "./src/quant.c", "./src/session.c", "./src/import.c"
+#define MODULE_HEADERS                                                                        \
+    "./src/points.h", "./src/transform.h", "./src/mesh.h", "./src/strip.h", "./src/labels.h", \
+    "./src/profiler.h", "./src/geometry.h", "./src/raster.h", "./src/stripify.h",             \
+    "./src/vcache.h", "./src/quant.h", "./src/session.h", "./src/import.h"
+
+// Appends the sources and headers of all modules to a list of input paths.
+void append_module_paths(Noh_File_Paths *paths) {
+    char *module_paths[] = { MODULE_SOURCES, MODULE_HEADERS };
+    noh_da_append_multiple(paths, module_paths, noh_array_len(module_paths));
+}
+
+// The path to write a trace of the build to, if requested.
+char *trace_path = NULL;
+
+// Writes the trace of the build on exit.
+void write_trace() {
+    noh_trace_write(trace_path);
+    noh_trace_free();
+}
+
 bool build_tristrip() {
     bool result = true;
+    noh_trace_begin("build tristrip");
     Noh_Arena arena = noh_arena_init(10 KB);
 
     Noh_Cmd cmd = {0};
     Noh_File_Paths input_paths = {0};
     noh_da_append(&input_paths, "./src/noh.h");
     noh_da_append(&input_paths, "./src/main.c");
+    append_module_paths(&input_paths);
     noh_da_append(&input_paths, "./lib/libraylib.a");
 
     int needs_rebuild = noh_output_is_older("./build/tristrip", input_paths.elems, input_paths.count);
@@ -27,17 +54,18 @@ bool build_tristrip() {
 
     // c-flags
     noh_cmd_append(&cmd, "-Wall", "-Wextra", "-ggdb");
+    noh_cmd_append(&cmd, "-DNOH_ARENA_STATS");
     noh_cmd_append(&cmd,  "-I./include/raylib-5.0");
 
     // Output
     noh_cmd_append(&cmd, "-o", "./build/tristrip");
 
     // Source
-    noh_cmd_append(&cmd, "./src/main.c");
+    noh_cmd_append(&cmd, "./src/main.c", MODULE_SOURCES);
 
     // Linker
     noh_cmd_append(&cmd, "-L./lib", "-l:libraylib.a");
-    noh_cmd_append(&cmd, "-lm");
+    noh_cmd_append(&cmd, "-lm", "-lpthread");
     // noh_cmd_append(&cmd, "-static");
 
     if (!noh_cmd_run_sync(cmd)) noh_return_defer(false);
@@ -46,17 +74,62 @@ defer:
     noh_cmd_free(&cmd);
     noh_da_free(&input_paths);
     noh_arena_free(&arena);
+    noh_trace_end("build tristrip");
     return result;
 }
 
+bool build_bench() {
+    bool result = true;
+    noh_trace_begin("build bench");
+
+    Noh_Cmd cmd = {0};
+    Noh_File_Paths input_paths = {0};
+    noh_da_append(&input_paths, "./src/noh.h");
+    noh_da_append(&input_paths, "./src/bench.c");
+    append_module_paths(&input_paths);
+    noh_da_append(&input_paths, "./lib/libraylib.a");
+
+    int needs_rebuild = noh_output_is_older("./build/bench", input_paths.elems, input_paths.count);
+    if (needs_rebuild < 0) noh_return_defer(false);
+    if (needs_rebuild == 0) {
+        noh_log(NOH_INFO, "bench is up to date.");
+        noh_return_defer(true);
+    }
+
+    noh_cmd_append(&cmd, COMPILER_TOOL);
+
+    // c-flags, benchmarks are only meaningful with optimizations.
+    noh_cmd_append(&cmd, "-Wall", "-Wextra", "-O2", "-march=native", "-ggdb");
+    noh_cmd_append(&cmd,  "-I./include/raylib-5.0");
+
+    // Output
+    noh_cmd_append(&cmd, "-o", "./build/bench");
+
+    // Source
+    noh_cmd_append(&cmd, "./src/bench.c", MODULE_SOURCES);
+
+    // Linker
+    noh_cmd_append(&cmd, "-L./lib", "-l:libraylib.a");
+    noh_cmd_append(&cmd, "-lm", "-lpthread");
+
+    if (!noh_cmd_run_sync(cmd)) noh_return_defer(false);
+
+defer:
+    noh_cmd_free(&cmd);
+    noh_da_free(&input_paths);
+    noh_trace_end("build bench");
+    return result;
+}
 
 void print_usage(char *program) {
-    noh_log(NOH_INFO, "Usage: %s <command>", program);
+    noh_log(NOH_INFO, "Usage: %s <command> [--trace <path>]", program);
     noh_log(NOH_INFO, "Available commands:");
     noh_log(NOH_INFO, "- build: build tristrip (default).");
     noh_log(NOH_INFO, "- run: build and run tristrip.");
     noh_log(NOH_INFO, "- test: build and debug tristrip using the defined debug tool.");
+    noh_log(NOH_INFO, "- bench: build and run the benchmarks.");
     noh_log(NOH_INFO, "- clean: clean all build artifacts.");
+    noh_log(NOH_INFO, "Pass --trace <path> to write a Chrome trace of the build steps to the specified path.");
 }
 
 int main(int argc, char **argv) {
@@ -71,6 +144,14 @@ int main(int argc, char **argv) {
         command = noh_shift_args(&argc, &argv);
     }
 
+    // Optionally record a trace of the build steps.
+    if (argc >= 2 && strcmp(argv[0], "--trace") == 0) {
+        noh_shift_args(&argc, &argv);
+        trace_path = noh_shift_args(&argc, &argv);
+        noh_trace_init(1 << 12);
+        atexit(write_trace);
+    }
+
     // Ensure build directory exists.
     if (!noh_mkdir_if_needed("./build")) return 1;
 
@@ -96,6 +177,15 @@ int main(int argc, char **argv) {
         if (!noh_cmd_run_sync(cmd)) return 1;
         noh_cmd_free(&cmd);
 
+    } else if (strcmp(command, "bench") == 0) {
+        // Build and run benchmarks.
+        if (!build_bench()) return 1;
+
+        Noh_Cmd cmd = {0};
+        noh_cmd_append(&cmd, "./build/bench");
+        if (!noh_cmd_run_sync(cmd)) return 1;
+        noh_cmd_free(&cmd);
+
     } else if (strcmp(command, "clean") == 0) {
         Noh_Cmd cmd = {0};
         noh_cmd_append(&cmd, "rm", "-rf", "./build/");
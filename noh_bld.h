@@ -100,7 +100,7 @@ noh_da_append_multiple(          \
 // Runs a command asynchronously and returns the process id.
 Noh_Pid noh_cmd_run_async(Noh_Cmd cmd);
 
-// Runs a command synchronously.
+// Runs a command synchronously. Records a trace span for the command if tracing is initialized.
 bool noh_cmd_run_sync(Noh_Cmd cmd);
 
 // Renders a textual representation of the command into the provided string.
@@ -315,10 +315,16 @@ Noh_Pid noh_cmd_run_async(Noh_Cmd cmd) {
 }
 
 bool noh_cmd_run_sync(Noh_Cmd cmd) {
+    // The span is named after the program that is run.
+    const char *name = cmd.count > 0 ? cmd.elems[0] : "cmd";
+    noh_trace_begin(name);
+
+    bool result = false;
     Noh_Pid pid = noh_cmd_run_async(cmd);
-    if (pid == NOH_INVALID_PROC) return false;
+    if (pid != NOH_INVALID_PROC) result = noh_proc_wait(pid);
 
-    return noh_proc_wait(pid);
+    noh_trace_end(name);
+    return result;
 }
 
 ///////////////////////// Building /////////////////////////
@@ -0,0 +1,731 @@
+// Benchmarks for the data structures and kernels used by tristrip.
+// Usage: bench [name], runs all benchmarks, or only those whose name contains the provided name.
+#include <stdio.h>
+#include <raylib.h>
+#include <raymath.h>
+
+#include "points.h"
+#include "transform.h"
+#include "raster.h"
+#include "stripify.h"
+#include "quant.h"
+#include "session.h"
+#include "import.h"
+#include "vcache.h"
+
+#define NOH_IMPLEMENTATION
+#include "noh.h"
+
+///////////////////////// Helpers /////////////////////////
+
+// A small deterministic random number generator, so runs are comparable.
+static uint64 bench_rng_state = 0x2545F4914F6CDD1Dul;
+static uint bench_rand() {
+    bench_rng_state ^= bench_rng_state << 13;
+    bench_rng_state ^= bench_rng_state >> 7;
+    bench_rng_state ^= bench_rng_state << 17;
+    return (uint)(bench_rng_state >> 32);
+}
+
+// Returns a random grid cell in a square of the specified size around the origin.
+static Vector2 bench_rand_cell(int size) {
+    Vector2 result = { .x = (int)(bench_rand() % size) - size / 2, .y = (int)(bench_rand() % size) - size / 2 };
+    return result;
+}
+
+// Reports the time per operation of a benchmark.
+static void bench_report(const char *name, uint64 elapsed_ns, size_t ops) {
+    printf("%-40s %12.1f ns/op %10zu ops %10.3f ms\n", name, (double)elapsed_ns / ops, ops, elapsed_ns / 1e6);
+}
+
+///////////////////////// Point lookup /////////////////////////
+
+// The linear scan that the point operations used before they were indexed.
+static int scan_find(Points *points, Vector2 pos) {
+    for (size_t i = 0; i < points->count; i++) {
+        if (points->elems[i].x == pos.x && points->elems[i].y == pos.y) return (int)i;
+    }
+
+    return -1;
+}
+
+static void bench_point_lookup() {
+    const size_t point_count = 200000;
+    const int grid_size = 2000;
+    const size_t scan_queries = 2000;
+    const size_t index_queries = 2000000;
+
+    // Fill a plain layer and an indexed layer with the same points.
+    Points scanned = {0};
+    Points indexed = {0};
+    while (indexed.count < point_count) add_point(&indexed, bench_rand_cell(grid_size));
+    noh_da_append_multiple(&scanned, indexed.elems, indexed.count);
+
+    Vector2 *queries = noh_realloc_check(NULL, index_queries * sizeof(Vector2));
+    for (size_t i = 0; i < index_queries; i++) queries[i] = bench_rand_cell(grid_size);
+
+    volatile int sink = 0;
+    uint64 start = noh_time_ns();
+    for (size_t i = 0; i < scan_queries; i++) sink += scan_find(&scanned, queries[i]);
+    bench_report("point lookup (scan)", noh_time_ns() - start, scan_queries);
+
+    start = noh_time_ns();
+    for (size_t i = 0; i < index_queries; i++) sink += points_find(&indexed, queries[i]);
+    bench_report("point lookup (index)", noh_time_ns() - start, index_queries);
+
+    // Adding points, which needs a lookup to prevent duplicates. Both layers start with the same points, and every
+    // point is added to the layer that the next lookups search.
+    Points added_scan = {0};
+    noh_da_append_multiple(&added_scan, scanned.elems, scanned.count);
+    start = noh_time_ns();
+    for (size_t i = 0; i < scan_queries; i++) {
+        if (scan_find(&added_scan, queries[i]) < 0) noh_da_append(&added_scan, queries[i]);
+    }
+    bench_report("point add (scan)", noh_time_ns() - start, scan_queries);
+
+    Points added_index = {0};
+    for (size_t i = 0; i < scanned.count; i++) add_point(&added_index, scanned.elems[i]);
+    start = noh_time_ns();
+    for (size_t i = 0; i < index_queries; i++) add_point(&added_index, queries[i]);
+    bench_report("point add (index)", noh_time_ns() - start, index_queries);
+
+    // Moving points around, every move needs two lookups.
+    start = noh_time_ns();
+    for (size_t i = 0; i < scan_queries; i++) {
+        int from = scan_find(&scanned, scanned.elems[i]);
+        if (scan_find(&scanned, queries[i]) < 0) scanned.elems[from] = queries[i];
+    }
+    bench_report("point move (scan)", noh_time_ns() - start, scan_queries);
+
+    start = noh_time_ns();
+    for (size_t i = 0; i < index_queries; i++) {
+        int from = start_moving(&indexed, indexed.elems[i % indexed.count]);
+        stop_moving(&indexed, from, queries[i]);
+    }
+    bench_report("point move (index)", noh_time_ns() - start, index_queries);
+
+    // Reordering points with the scroll wheel.
+    start = noh_time_ns();
+    for (size_t i = 0; i < index_queries; i++) {
+        move_point_index(&indexed, indexed.elems[i % (indexed.count - 1)], 1);
+    }
+    bench_report("point reorder (index)", noh_time_ns() - start, index_queries);
+    (void)sink;
+
+    free(queries);
+    points_free(&scanned);
+    points_free(&indexed);
+    points_free(&added_scan);
+    points_free(&added_index);
+}
+
+///////////////////////// Screen transforms /////////////////////////
+
+static void bench_transform() {
+    const size_t point_count = 10000000;
+    const int rounds = 10;
+    const Vector2 center = { .x = 400, .y = 300 };
+    const float spacing = 50;
+
+    Vector2 *grid = noh_realloc_check(NULL, point_count * sizeof(Vector2));
+    Vector2 *other = noh_realloc_check(NULL, point_count * sizeof(Vector2));
+    Vector2 *screen = noh_realloc_check(NULL, point_count * sizeof(Vector2));
+    for (size_t i = 0; i < point_count; i++) {
+        grid[i] = bench_rand_cell(1000);
+        other[i] = bench_rand_cell(1000);
+    }
+
+    printf("%zu points per round, a frame at 60 fps is 16.7 ms\n", point_count);
+
+    // The per point raymath conversion that was used before.
+    uint64 start = noh_time_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < point_count; i++) screen[i] = Vector2Add(center, Vector2Scale(grid[i], spacing));
+    }
+    bench_report("grid to screen (raymath)", (noh_time_ns() - start) / rounds, point_count);
+
+    start = noh_time_ns();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < point_count; i++) screen[i] = Vector2Lerp(grid[i], other[i], 0.5);
+    }
+    bench_report("lerp (raymath)", (noh_time_ns() - start) / rounds, point_count);
+
+    for (Transform_Kernel k = TRANSFORM_SCALAR; k <= transform_best_kernel(); k++) {
+        char name[64];
+        start = noh_time_ns();
+        for (int r = 0; r < rounds; r++) transform_scale_offset_with(k, screen, grid, point_count, spacing, center);
+        snprintf(name, sizeof(name), "grid to screen (%s)", transform_kernel_name(k));
+        bench_report(name, (noh_time_ns() - start) / rounds, point_count);
+
+        start = noh_time_ns();
+        for (int r = 0; r < rounds; r++) transform_lerp_with(k, screen, grid, other, point_count, 0.5);
+        snprintf(name, sizeof(name), "lerp (%s)", transform_kernel_name(k));
+        bench_report(name, (noh_time_ns() - start) / rounds, point_count);
+    }
+
+    // Arrays pushed to an arena are aligned, so the kernels only use aligned loads and stores. Shifting the input by
+    // one vector leaves only the stores aligned.
+    Noh_Arena arena = noh_arena_init_virtual((size_t)1 GB);
+    Vector2 *aligned_grid = noh_arena_push(&arena, Vector2, point_count + 1);
+    Vector2 *aligned_screen = noh_arena_push(&arena, Vector2, point_count);
+    memcpy(aligned_grid + 1, grid, point_count * sizeof(Vector2));
+    memset(aligned_screen, 0, point_count * sizeof(Vector2));
+    for (int shift = 0; shift <= 1; shift++) {
+        char name[64];
+        start = noh_time_ns();
+        for (int r = 0; r < rounds; r++) {
+            transform_scale_offset(aligned_screen, aligned_grid + shift, point_count, spacing, center);
+        }
+        snprintf(name, sizeof(name), "grid to screen (%s, %s)", transform_kernel_name(transform_best_kernel()),
+            shift == 0 ? "aligned" : "unaligned input");
+        bench_report(name, (noh_time_ns() - start) / rounds, point_count);
+    }
+    noh_arena_free(&arena);
+
+    free(grid);
+    free(other);
+    free(screen);
+}
+
+///////////////////////// Rasterization /////////////////////////
+
+static void bench_raster() {
+    const int width = 3840;
+    const int height = 2160;
+    const size_t layer_count = 500;
+    const size_t points_per_layer = 200;
+    const float spacing = 20;
+    const int rounds = 5;
+    const Vector2 center = { .x = width / 2, .y = height / 2 };
+    const Layer_Colors colors = { .fill = RED, .lines = GREEN, .points = ORANGE };
+
+    // Random layers of points around a wandering spot, so triangles range from a few pixels to a few hundred.
+    Raster_Scene scene = raster_scene_init(width, height);
+    Points points = {0};
+    size_t vertex_count = layer_geometry_vertex_count(points_per_layer);
+    Geometry_Vertex *vertices = noh_realloc_check(NULL, sizeof(Geometry_Vertex) * vertex_count);
+    uint64 start = noh_time_ns();
+    for (size_t l = 0; l < layer_count; l++) {
+        Vector2 spot = bench_rand_cell(160);
+        spot.y = spot.y * 9 / 16;
+        noh_da_reset(&points);
+        for (size_t i = 0; i < points_per_layer; i++) {
+            noh_da_append(&points, Vector2Add(spot, bench_rand_cell(6)));
+        }
+        layer_geometry_build(vertices, points.elems, points.count, spacing, center, colors);
+        raster_scene_add(&scene, vertices, vertex_count);
+    }
+    size_t triangle_count = raster_scene_triangle_count(&scene);
+    bench_report("raster binning", noh_time_ns() - start, triangle_count);
+
+    printf("%zu front facing triangles on %dx%d, in %dx%d tiles\n", triangle_count, width, height,
+        RASTER_TILE_SIZE, RASTER_TILE_SIZE);
+
+    Image image = raster_image_alloc(width, height, BLACK);
+    double single_ns = 0;
+    size_t max_threads = raster_thread_count();
+    for (size_t threads = 1;; threads = min(threads * 2, max_threads)) {
+        start = noh_time_ns();
+        for (int r = 0; r < rounds; r++) raster_scene_draw(&scene, &image, threads);
+        double elapsed_ns = (double)(noh_time_ns() - start) / rounds;
+        if (threads == 1) single_ns = elapsed_ns;
+
+        char name[64];
+        snprintf(name, sizeof(name), "raster (%zu threads)", threads);
+        bench_report(name, elapsed_ns, triangle_count);
+        printf("%-40s %12.2f Mtris/s %9.2fx\n", "", triangle_count / elapsed_ns * 1e3, single_ns / elapsed_ns);
+        if (threads == max_threads) break;
+    }
+
+    UnloadImage(image);
+    free(vertices);
+    points_free(&points);
+    raster_scene_free(&scene);
+}
+
+///////////////////////// Stripification /////////////////////////
+
+static void bench_stripify() {
+    const uint size = 1000;
+    const size_t triangle_count = 2 * (size_t)size * size;
+
+    // A regular grid of quads, split into two triangles each and shuffled, like a mesh that was never optimized.
+    uint *indices = noh_realloc_check(NULL, 3 * triangle_count * sizeof(uint));
+    size_t n = 0;
+    for (uint y = 0; y < size; y++) {
+        for (uint x = 0; x < size; x++) {
+            uint a = y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+            indices[n++] = a; indices[n++] = c; indices[n++] = b;
+            indices[n++] = b; indices[n++] = c; indices[n++] = d;
+        }
+    }
+    for (size_t i = triangle_count - 1; i > 0; i--) {
+        size_t j = bench_rand() % (i + 1);
+        for (int k = 0; k < 3; k++) {
+            uint temp = indices[3 * i + k];
+            indices[3 * i + k] = indices[3 * j + k];
+            indices[3 * j + k] = temp;
+        }
+    }
+
+    Strips strips = {0};
+    uint64 start = noh_time_ns();
+    stripify(&strips, indices, 3 * triangle_count, (size_t)(size + 1) * (size + 1), NULL, 0);
+    bench_report("stripify (grid, shuffled)", noh_time_ns() - start, triangle_count);
+    strips_log_stats(&strips);
+
+    strips_free(&strips);
+    free(indices);
+}
+
+///////////////////////// Quantized storage /////////////////////////
+
+static void bench_quant_layer(const char *name, Vector2 *grid, size_t point_count, Vector2 *screen, int rounds) {
+    const Vector2 center = { .x = 400, .y = 300 };
+    const float spacing = 50;
+    char label[64];
+
+    Quant_Points quant = {0};
+    uint64 start = noh_time_ns();
+    quant_encode(&quant, grid, point_count);
+    snprintf(label, sizeof(label), "quant encode (%s)", name);
+    bench_report(label, noh_time_ns() - start, point_count);
+    printf("%-40s %12.2f bytes/point, %.2fx smaller than Vector2\n", "", (double)quant_memory(&quant) / point_count,
+        (double)point_count * sizeof(Vector2) / quant_memory(&quant));
+
+    start = noh_time_ns();
+    for (int r = 0; r < rounds; r++) quant_to_screen(&quant, screen, spacing, center);
+    snprintf(label, sizeof(label), "quant to screen (%s)", name);
+    bench_report(label, (noh_time_ns() - start) / rounds, point_count);
+
+    quant_free(&quant);
+}
+
+static void bench_quant() {
+    const size_t point_count = 10000000;
+    const int rounds = 10;
+
+    Vector2 *grid = noh_realloc_check(NULL, point_count * sizeof(Vector2));
+    Vector2 *screen = noh_realloc_check(NULL, point_count * sizeof(Vector2));
+
+    // Layers drawn by hand wander around in small steps, these fit in 8-bit offsets.
+    Vector2 pos = {0};
+    for (size_t i = 0; i < point_count; i++) {
+        pos = Vector2Add(pos, bench_rand_cell(5));
+        grid[i] = pos;
+    }
+    bench_quant_layer("walk", grid, point_count, screen, rounds);
+
+    // Points all over a large area need 16-bit offsets.
+    for (size_t i = 0; i < point_count; i++) grid[i] = bench_rand_cell(20000);
+    bench_quant_layer("scattered", grid, point_count, screen, rounds);
+
+    const Vector2 center = { .x = 400, .y = 300 };
+    uint64 start = noh_time_ns();
+    for (int r = 0; r < rounds; r++) transform_scale_offset(screen, grid, point_count, 50, center);
+    bench_report("float to screen", (noh_time_ns() - start) / rounds, point_count);
+
+    free(grid);
+    free(screen);
+}
+
+///////////////////////// Sessions /////////////////////////
+
+static void bench_session() {
+    const size_t layer_count = 10;
+    const size_t points_per_layer = 1000000;
+    const size_t text_points_per_layer = 100000;
+    const char *session_path = "/tmp/tristrip-bench.session";
+    const char *text_path = "/tmp/tristrip-bench.txt";
+
+    Layers layers = {0};
+    for (size_t l = 0; l < layer_count; l++) {
+        Points points = {0};
+        for (size_t i = 0; i < points_per_layer; i++) noh_da_append(&points, bench_rand_cell(20000));
+        noh_da_append(&layers, points);
+    }
+    size_t point_count = layer_count * points_per_layer;
+
+    uint64 start = noh_time_ns();
+    session_save(&layers, session_path);
+    bench_report("session save", noh_time_ns() - start, point_count);
+
+    // Loading only maps the file, reading the points is what touches the pages.
+    Session session = {0};
+    Layers loaded = {0};
+    start = noh_time_ns();
+    session_load(&session, &loaded, session_path);
+    bench_report("session load", noh_time_ns() - start, point_count);
+
+    volatile float sink = 0;
+    start = noh_time_ns();
+    for (size_t l = 0; l < loaded.count; l++) {
+        for (size_t i = 0; i < loaded.elems[l].count; i++) sink += loaded.elems[l].elems[i].x;
+    }
+    bench_report("session first read", noh_time_ns() - start, point_count);
+
+    // The index of a layer is built on the first lookup.
+    start = noh_time_ns();
+    sink += points_find(&loaded.elems[0], loaded.elems[0].elems[0]);
+    bench_report("session first lookup (one layer)", noh_time_ns() - start, points_per_layer);
+
+    // The text format parses and indexes every point on load, a smaller file is enough to compare per point.
+    FILE *f = fopen(text_path, "w");
+    for (size_t l = 0; l < layer_count; l++) {
+        for (size_t i = 0; i < text_points_per_layer; i++) {
+            fprintf(f, "%g %g\n", layers.elems[l].elems[i].x, layers.elems[l].elems[i].y);
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+
+    Layers text = {0};
+    start = noh_time_ns();
+    layers_load_text(&text, text_path);
+    bench_report("text load", noh_time_ns() - start, layer_count * text_points_per_layer);
+
+    layers_free(&text);
+    layers_free(&loaded);
+    session_unmap(&session);
+    layers_free(&layers);
+    remove(session_path);
+    remove(text_path);
+}
+
+///////////////////////// Import /////////////////////////
+
+static void bench_import() {
+    const int grid_size = 700;
+    const char *path = "/tmp/tristrip-bench.obj";
+
+    // A grid of quads, as exported by most tools, with positions noisy enough to use all digits.
+    FILE *f = fopen(path, "w");
+    for (int y = 0; y <= grid_size; y++) {
+        for (int x = 0; x <= grid_size; x++) {
+            fprintf(f, "v %.6f %.6f %.6f\n", x + bench_rand() / 4e10, y + bench_rand() / 4e10, bench_rand() / 4e9);
+        }
+    }
+    for (int y = 0; y < grid_size; y++) {
+        for (int x = 0; x < grid_size; x++) {
+            int v = y * (grid_size + 1) + x + 1;
+            fprintf(f, "f %d/%d %d/%d %d/%d %d/%d\n", v, v, v + 1, v + 1, v + grid_size + 2, v + grid_size + 2,
+                v + grid_size + 1, v + grid_size + 1);
+        }
+    }
+    long size = ftell(f);
+    fclose(f);
+
+    Layers layers = {0};
+    uint64 start = noh_time_ns();
+    import_mesh(&layers, path);
+    uint64 elapsed = noh_time_ns() - start;
+    bench_report("import obj", elapsed, (size_t)grid_size * grid_size * 2);
+    printf("%-40s %12.1f MB/s, including stripifying\n", "", size / (elapsed / 1e9) / (1 << 20));
+
+    // The ACMR shown for the active layer. Imported points are off the grid, so none of them are in the point index.
+    Points *points = &layers.elems[0];
+    uint *ids = noh_realloc_check(NULL, points->count * sizeof(uint));
+    start = noh_time_ns();
+    points_vertex_ids(points, ids);
+    double acmr = vcache_acmr(ids, points->count, true, VCACHE_FIFO, 16);
+    bench_report("imported layer acmr", noh_time_ns() - start, points->count);
+    printf("%-40s %12.2f ACMR for %zu strip points\n", "", acmr, points->count);
+    free(ids);
+
+    layers_free(&layers);
+    remove(path);
+}
+
+///////////////////////// Arena /////////////////////////
+
+// Allocates like a frame does: temporary data in nested scopes, with a few large buffers between many small ones.
+static void bench_arena_frames(const char *name, Noh_Arena *arena, size_t frames) {
+    const size_t allocs_per_scope = 64;
+    const size_t scopes_per_frame = 16;
+
+    volatile char sink = 0;
+    uint64 start = noh_time_ns();
+    for (size_t f = 0; f < frames; f++) {
+        noh_arena_save(arena);
+        for (size_t s = 0; s < scopes_per_frame; s++) {
+            noh_arena_save(arena);
+            for (size_t a = 0; a < allocs_per_scope; a++) {
+                size_t size = a % 16 == 0 ? 64 KB : 16 + (a * 24) % 256;
+                char *data = noh_arena_alloc(arena, size);
+                data[0] = (char)a;
+                sink += data[0];
+            }
+            noh_arena_rewind(arena);
+        }
+        noh_arena_rewind(arena);
+    }
+    bench_report(name, noh_time_ns() - start, frames * scopes_per_frame * allocs_per_scope);
+}
+
+// Formats a short string in a scope of its own, like the text overlays do several times per frame.
+static void bench_arena_scopes(const char *name, Noh_Arena *arena, bool marks, size_t scopes) {
+    volatile char sink = 0;
+    uint64 start = noh_time_ns();
+    for (size_t i = 0; i < scopes; i++) {
+        if (marks) {
+            Noh_Arena_Mark mark = noh_arena_mark(arena);
+            char *data = noh_arena_alloc(arena, 16);
+            data[0] = (char)i;
+            sink += data[0];
+            noh_arena_rewind_to(arena, mark);
+        } else {
+            noh_arena_save(arena);
+            char *data = noh_arena_alloc(arena, 16);
+            data[0] = (char)i;
+            sink += data[0];
+            noh_arena_rewind(arena);
+        }
+    }
+    bench_report(name, noh_time_ns() - start, scopes);
+}
+
+// Frames that need a few KB, with an expensive frame every few frames that needs a few MB, like a large animation
+// that repeats. The arena is reset at the start of every frame.
+static void bench_arena_retention(const char *name, Noh_Arena_Retention retention, size_t frames) {
+    const size_t expensive_every = 8;
+
+    Noh_Arena arena = noh_arena_init(1 KB);
+    noh_arena_retain(&arena, retention, 8 MB);
+    volatile char sink = 0;
+    uint64 start = noh_time_ns();
+    for (size_t f = 0; f < frames; f++) {
+        noh_arena_reset(&arena);
+        // The expensive frames alternate between a few sizes, like animations between different layers.
+        size_t size = f % expensive_every == 0 ? (64 KB) << (f / expensive_every % 4) : 2 KB;
+        for (size_t a = 0; a < 32; a++) {
+            char *data = noh_arena_alloc(&arena, size);
+            data[size - 1] = (char)a;
+            sink += data[size - 1];
+        }
+    }
+    bench_report(name, noh_time_ns() - start, frames);
+    noh_arena_free(&arena);
+}
+
+// Builds a new dynamic array every frame, like the stitched strip, and frees it at the end of the frame. With a batch
+// larger than 1, the points are appended that many at once, like the strip of a layer.
+static void bench_arena_da(const char *name, Noh_Arena *arena, size_t batch, size_t frames) {
+    const size_t appends = 100000;
+
+    Noh_Allocator allocator = arena != NULL ? noh_arena_allocator(arena) : noh_heap_allocator();
+    Vector2 batch_points[64];
+    noh_assert(batch > 0 && batch <= noh_array_len(batch_points) && appends % batch == 0);
+    volatile float sink = 0;
+    uint64 start = noh_time_ns();
+    for (size_t f = 0; f < frames; f++) {
+        Points points = {0};
+        for (size_t i = 0; i < appends; i += batch) {
+            for (size_t j = 0; j < batch; j++) batch_points[j] = CLITERAL(Vector2) { i + j, f };
+            if (batch == 1) noh_da_append_with(allocator, &points, batch_points[0]);
+            else noh_da_append_multiple_with(allocator, &points, batch_points, batch);
+        }
+        sink += points.elems[f % appends].x;
+        noh_da_free_with(allocator, &points);
+    }
+    bench_report(name, noh_time_ns() - start, frames * appends);
+}
+
+static void bench_arena() {
+    const size_t frames = 20000;
+    const size_t scopes = 10000000;
+
+    Noh_Arena blocks = noh_arena_init(1 KB);
+    bench_arena_frames("arena alloc (blocks)", &blocks, frames);
+    noh_arena_free(&blocks);
+
+    Noh_Arena virtual = noh_arena_init_virtual((size_t)1 GB);
+    bench_arena_frames("arena alloc (virtual)", &virtual, frames);
+    noh_arena_free(&virtual);
+
+    blocks = noh_arena_init(1 KB);
+    bench_arena_scopes("arena scope (checkpoints)", &blocks, false, scopes);
+    bench_arena_scopes("arena scope (marks)", &blocks, true, scopes);
+    noh_arena_free(&blocks);
+
+    bench_arena_da("da per frame (heap)", NULL, 1, 200);
+    bench_arena_da("da per frame, batches of 32 (heap)", NULL, 32, 200);
+    virtual = noh_arena_init_virtual((size_t)1 GB);
+    bench_arena_da("da per frame (arena)", &virtual, 1, 200);
+    bench_arena_da("da per frame, batches of 32 (arena)", &virtual, 32, 200);
+    noh_arena_free(&virtual);
+
+    bench_arena_retention("arena frames (free empty)", NOH_ARENA_FREE_EMPTY, frames);
+    bench_arena_retention("arena frames (keep 8 MB)", NOH_ARENA_KEEP_BYTES, frames);
+    bench_arena_retention("arena frames (merge on reset)", NOH_ARENA_MERGE_ON_RESET, frames);
+
+    // Growing a single allocation, like the points of a layer that keeps getting larger.
+    const size_t grow_steps = 20;
+    blocks = noh_arena_init(1 KB);
+    virtual = noh_arena_init_virtual((size_t)1 GB);
+    uint64 start = noh_time_ns();
+    for (size_t i = 0; i < grow_steps; i++) {
+        noh_arena_save(&blocks);
+        memset(noh_arena_alloc(&blocks, (16 KB) << (i % 10)), 0, (16 KB) << (i % 10));
+        noh_arena_rewind(&blocks);
+    }
+    bench_report("arena grow (blocks)", noh_time_ns() - start, grow_steps);
+    start = noh_time_ns();
+    for (size_t i = 0; i < grow_steps; i++) {
+        noh_arena_save(&virtual);
+        memset(noh_arena_alloc(&virtual, (16 KB) << (i % 10)), 0, (16 KB) << (i % 10));
+        noh_arena_rewind(&virtual);
+    }
+    bench_report("arena grow (virtual)", noh_time_ns() - start, grow_steps);
+    noh_arena_free(&blocks);
+    noh_arena_free(&virtual);
+}
+
+///////////////////////// Pool /////////////////////////
+
+typedef enum {
+    POOL_MALLOC,
+    POOL_RELEASE,
+    POOL_RESET,
+} Pool_Mode;
+
+// Allocates many small objects, frees and allocates a random half of them again, and then frees all of them. With
+// POOL_RESET, the pool frees them all at once.
+static void bench_pool_objects(const char *name, Pool_Mode mode, void **objects, size_t count, size_t rounds) {
+    const size_t object_size = 32;
+
+    Noh_Pool pool = noh_pool_init(object_size);
+    volatile char sink = 0;
+    uint64 start = noh_time_ns();
+    for (size_t r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            objects[i] = mode == POOL_MALLOC ? malloc(object_size) : noh_pool_alloc(&pool);
+            memset(objects[i], (int)i, object_size);
+        }
+        for (size_t i = 0; i < count / 2; i++) {
+            size_t j = bench_rand() % count;
+            if (mode == POOL_MALLOC) free(objects[j]);
+            else noh_pool_release(&pool, objects[j]);
+            objects[j] = mode == POOL_MALLOC ? malloc(object_size) : noh_pool_alloc(&pool);
+            memset(objects[j], (int)j, object_size);
+        }
+        for (size_t i = 0; i < count; i++) sink += *(char *)objects[i];
+
+        if (mode == POOL_RESET) {
+            noh_pool_reset(&pool);
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                if (mode == POOL_MALLOC) free(objects[i]);
+                else noh_pool_release(&pool, objects[i]);
+            }
+        }
+    }
+    bench_report(name, noh_time_ns() - start, rounds * count * 3 / 2);
+    noh_pool_free(&pool);
+}
+
+typedef struct {
+    uint *elems;
+    size_t count;
+    size_t capacity;
+} Neighbours;
+
+typedef struct {
+    float *elems;
+    size_t count;
+    size_t capacity;
+    size_t start;
+} History;
+
+// Gives many objects a short array, like the neighbours of a vertex, which is appended to and freed again. Without a
+// pool, the arrays are allocated on the heap.
+static void bench_pool_arrays(const char *name, Noh_Pool *pool, size_t count, size_t rounds) {
+    const size_t length = 12;
+
+    Noh_Allocator allocator = pool != NULL ? noh_pool_allocator(pool) : noh_heap_allocator();
+    Neighbours *arrays = noh_realloc_check(NULL, count * sizeof(Neighbours));
+    memset(arrays, 0, count * sizeof(Neighbours));
+    volatile uint sink = 0;
+    uint64 start = noh_time_ns();
+    for (size_t r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < length; j++) noh_da_append_with(allocator, &arrays[i], (uint)(i + j));
+        }
+        for (size_t i = 0; i < count; i++) sink += arrays[i].elems[i % length];
+        for (size_t i = 0; i < count; i++) noh_da_free_with(allocator, &arrays[i]);
+    }
+    bench_report(name, noh_time_ns() - start, rounds * count);
+    free(arrays);
+}
+
+// Gives many objects a short circular buffer, like a history of recent values, which is filled and freed again.
+// Without a pool, the buffers are allocated on the heap.
+static void bench_pool_histories(const char *name, Noh_Pool *pool, size_t count, size_t rounds) {
+    const size_t length = 8;
+    const size_t inserts = 20;
+
+    Noh_Allocator allocator = pool != NULL ? noh_pool_allocator(pool) : noh_heap_allocator();
+    History *histories = noh_realloc_check(NULL, count * sizeof(History));
+    memset(histories, 0, count * sizeof(History));
+    volatile float sink = 0;
+    uint64 start = noh_time_ns();
+    for (size_t r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            noh_cb_initialize_with(allocator, &histories[i], length);
+            for (size_t j = 0; j < inserts; j++) noh_cb_insert(&histories[i], (float)(i + j));
+        }
+        for (size_t i = 0; i < count; i++) sink += histories[i].elems[histories[i].start];
+        for (size_t i = 0; i < count; i++) noh_da_free_with(allocator, &histories[i]);
+    }
+    bench_report(name, noh_time_ns() - start, rounds * count);
+    free(histories);
+}
+
+static void bench_pool() {
+    const size_t count = 1000000;
+    const size_t rounds = 5;
+
+    void **objects = noh_realloc_check(NULL, count * sizeof(void *));
+    bench_pool_objects("small objects (malloc)", POOL_MALLOC, objects, count, rounds);
+    bench_pool_objects("small objects (pool)", POOL_RELEASE, objects, count, rounds);
+    bench_pool_objects("small objects (pool, bulk free)", POOL_RESET, objects, count, rounds);
+    free(objects);
+
+    Noh_Pool pool = noh_pool_init(16 * sizeof(uint));
+    bench_pool_arrays("small arrays (heap)", NULL, count, rounds);
+    bench_pool_arrays("small arrays (pool)", &pool, count, rounds);
+    bench_pool_histories("small histories (heap)", NULL, count, rounds);
+    bench_pool_histories("small histories (pool)", &pool, count, rounds);
+    noh_pool_free(&pool);
+}
+
+///////////////////////// Main /////////////////////////
+
+typedef struct {
+    const char *name;
+    void (*run)();
+} Bench;
+
+static Bench benches[] = {
+    { "point_lookup", bench_point_lookup },
+    { "transform", bench_transform },
+    { "raster", bench_raster },
+    { "stripify", bench_stripify },
+    { "quant", bench_quant },
+    { "session", bench_session },
+    { "import", bench_import },
+    { "arena", bench_arena },
+    { "pool", bench_pool },
+};
+
+int main(int argc, char **argv) {
+    noh_shift_args(&argc, &argv);
+    const char *filter = argc > 0 ? noh_shift_args(&argc, &argv) : "";
+
+    for (size_t i = 0; i < noh_array_len(benches); i++) {
+        if (strstr(benches[i].name, filter) == NULL) continue;
+        printf("== %s ==\n", benches[i].name);
+        benches[i].run();
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <math.h>
+#include "geometry.h"
+#include <raymath.h>
+
+static float cross(Vector2 a, Vector2 b, Vector2 c) {
+    return (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+}
+
+// Appends a triangle, keeping the vertex order.
+static Geometry_Vertex *push_triangle(Geometry_Vertex *v, Vector2 a, Vector2 b, Vector2 c, Color color) {
+    v[0] = (Geometry_Vertex) { a, color };
+    v[1] = (Geometry_Vertex) { b, color };
+    v[2] = (Geometry_Vertex) { c, color };
+    return v + 3;
+}
+
+// Appends a triangle, ordered counter-clockwise on screen so it survives backface culling.
+static Geometry_Vertex *push_front_triangle(Geometry_Vertex *v, Vector2 a, Vector2 b, Vector2 c, Color color) {
+    if (cross(a, b, c) > 0) return push_triangle(v, a, c, b, color);
+    return push_triangle(v, a, b, c, color);
+}
+
+size_t layer_geometry_vertex_count(size_t count) {
+    size_t fill_vertices = count >= 3 ? 3 * (count - 2) : 0;
+    size_t line_vertices = count >= 2 ? 6 * (count - 1) : 0;
+    size_t point_vertices = 3 * GEOMETRY_CIRCLE_SEGMENTS * count;
+    return fill_vertices + line_vertices + point_vertices;
+}
+
+void geometry_line_strip(Vector2 a, Vector2 b, float width, Vector2 strip[4]) {
+    Vector2 dir = Vector2Normalize(Vector2Subtract(b, a));
+    Vector2 normal = { .x = -dir.y * width / 2.0, .y = dir.x * width / 2.0 };
+    strip[0] = Vector2Add(a, normal);
+    strip[1] = Vector2Subtract(a, normal);
+    strip[2] = Vector2Add(b, normal);
+    strip[3] = Vector2Subtract(b, normal);
+
+    // Both triangles of the quad have the same winding, mirror the quad if it faces the back.
+    if (cross(strip[0], strip[1], strip[2]) > 0) {
+        Vector2 temp = strip[0];
+        strip[0] = strip[1];
+        strip[1] = temp;
+        temp = strip[2];
+        strip[2] = strip[3];
+        strip[3] = temp;
+    }
+}
+
+void geometry_circle_strip(Vector2 center, Vector2 strip[GEOMETRY_CIRCLE_SEGMENTS]) {
+    // Corners by decreasing angle, which is counter-clockwise on screen. The strip takes them from both ends at
+    // once, 0, 1, n-1, 2, n-2, ..., so every triangle visits its corners in that same order.
+    for (int i = 0; i < GEOMETRY_CIRCLE_SEGMENTS; i++) {
+        int corner = i % 2 == 1 ? (i + 1) / 2 : (GEOMETRY_CIRCLE_SEGMENTS - i / 2) % GEOMETRY_CIRCLE_SEGMENTS;
+        float angle = -2 * PI * corner / GEOMETRY_CIRCLE_SEGMENTS;
+        strip[i] = CLITERAL(Vector2) {
+            center.x + cosf(angle) * GEOMETRY_POINT_RADIUS, center.y + sinf(angle) * GEOMETRY_POINT_RADIUS
+        };
+    }
+}
+
+Geometry_Vertex *geometry_push_line(Geometry_Vertex *v, Vector2 a, Vector2 b, float width, Color color) {
+    Vector2 q[4];
+    geometry_line_strip(a, b, width, q);
+    v = push_triangle(v, q[0], q[1], q[2], color);
+    v = push_triangle(v, q[1], q[3], q[2], color);
+    return v;
+}
+
+Geometry_Vertex *layer_geometry_build(Geometry_Vertex *v, Vector2 *points, size_t count, float spacing,
+    Vector2 offset, Layer_Colors colors) {
+    // Filled triangle strip, in the same vertex order as DrawTriangleStrip so the same triangles are culled.
+    for (size_t i = 2; i < count; i++) {
+        Vector2 p0 = Vector2Add(offset, Vector2Scale(points[i - 2], spacing));
+        Vector2 p1 = Vector2Add(offset, Vector2Scale(points[i - 1], spacing));
+        Vector2 p2 = Vector2Add(offset, Vector2Scale(points[i], spacing));
+        if (i % 2 == 0) v = push_triangle(v, p2, p0, p1, colors.fill);
+        else v = push_triangle(v, p2, p1, p0, colors.fill);
+    }
+
+    // Lines between points, as thin quads.
+    for (size_t i = 1; i < count; i++) {
+        Vector2 a = Vector2Add(offset, Vector2Scale(points[i - 1], spacing));
+        Vector2 b = Vector2Add(offset, Vector2Scale(points[i], spacing));
+        v = geometry_push_line(v, a, b, GEOMETRY_LINE_WIDTH, colors.lines);
+    }
+
+    // Point circles, as triangle fans.
+    for (size_t i = 0; i < count; i++) {
+        Vector2 c = Vector2Add(offset, Vector2Scale(points[i], spacing));
+        for (int s = 0; s < GEOMETRY_CIRCLE_SEGMENTS; s++) {
+            float a0 = 2 * PI * s / GEOMETRY_CIRCLE_SEGMENTS;
+            float a1 = 2 * PI * (s + 1) / GEOMETRY_CIRCLE_SEGMENTS;
+            Vector2 p0 = { c.x + cosf(a0) * GEOMETRY_POINT_RADIUS, c.y + sinf(a0) * GEOMETRY_POINT_RADIUS };
+            Vector2 p1 = { c.x + cosf(a1) * GEOMETRY_POINT_RADIUS, c.y + sinf(a1) * GEOMETRY_POINT_RADIUS };
+            v = push_front_triangle(v, c, p0, p1, colors.points);
+        }
+    }
+
+    return v;
+}
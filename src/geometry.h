@@ -0,0 +1,46 @@
+#ifndef GEOMETRY_H_
+#define GEOMETRY_H_
+
+#include <raylib.h>
+#include "noh.h"
+
+// Triangle geometry for everything that is drawn of a layer: the filled triangle strip, the lines between points and
+// the point circles. Shared by the GPU meshes and the software rasterizer, so both draw exactly the same triangles.
+
+#define GEOMETRY_CIRCLE_SEGMENTS 16
+#define GEOMETRY_POINT_RADIUS 5
+#define GEOMETRY_LINE_WIDTH 1
+
+// A vertex of a triangle list or strip.
+typedef struct {
+    Vector2 position;
+    Color color;
+} Geometry_Vertex;
+
+// The colors that the geometry of a layer is built with.
+typedef struct {
+    Color fill;
+    Color lines;
+    Color points;
+} Layer_Colors;
+
+// Returns the number of vertices the geometry of a layer with the specified number of points takes.
+size_t layer_geometry_vertex_count(size_t count);
+
+// Writes the geometry of a layer, with points in grid coordinates, to the output, which needs room for
+// layer_geometry_vertex_count vertices. Points are scaled by spacing and moved by offset.
+// The strip triangles keep the vertex order of DrawTriangleStrip, so backface culling hides the same triangles. All
+// other triangles are ordered to face the front. Returns the end of the written vertices.
+Geometry_Vertex *layer_geometry_build(Geometry_Vertex *out, Vector2 *points, size_t count, float spacing,
+    Vector2 offset, Layer_Colors colors);
+
+// Writes a line as a quad of two front facing triangles. Returns the end of the written vertices.
+Geometry_Vertex *geometry_push_line(Geometry_Vertex *out, Vector2 a, Vector2 b, float width, Color color);
+
+// Computes the corners of the quad for a line, as a front facing triangle strip of four vertices.
+void geometry_line_strip(Vector2 a, Vector2 b, float width, Vector2 strip[4]);
+
+// Computes the corners of a point circle, as a front facing triangle strip zigzagging across the circle.
+void geometry_circle_strip(Vector2 center, Vector2 strip[GEOMETRY_CIRCLE_SEGMENTS]);
+
+#endif // GEOMETRY_H_
@@ -0,0 +1,449 @@
+#include <limits.h>
+#include <math.h>
+#include "import.h"
+#include "stripify.h"
+
+typedef struct {
+    Vector2 *elems;
+    size_t count;
+    size_t capacity;
+} Import_Positions;
+
+// A mesh as it is parsed, before it is stripified.
+typedef struct {
+    Import_Positions positions;
+    Strip_Indices indices; // Three per triangle.
+} Import_Mesh;
+
+///////////////////////// Reading /////////////////////////
+
+// Reads a file line by line, through a buffer of IMPORT_CHUNK_SIZE bytes.
+typedef struct {
+    const char *path;
+    FILE *f;
+    char *buf;
+    Noh_String_View rest; // The part of the buffer that is read, but not returned as a line yet.
+    bool eof;
+    bool failed;
+    size_t line_number;
+} Import_Reader;
+
+// Returns the next line of the file. Returns false at the end of the file, or if it could not be read, which is
+// indicated by failed.
+static bool next_line(Import_Reader *r, Noh_String_View *line) {
+    for (;;) {
+        if (r->failed) return false;
+        bool has_line = r->rest.count > 0 && memchr(r->rest.elems, '\n', r->rest.count) != NULL;
+        if (has_line || (r->eof && r->rest.count > 0)) {
+            *line = noh_sv_chop_by_delim(&r->rest, '\n');
+            r->line_number++;
+            return true;
+        }
+        if (r->eof) return false;
+
+        // Move the partial line to the start of the buffer and fill the rest of it.
+        if (r->rest.count == IMPORT_CHUNK_SIZE) {
+            noh_log(NOH_ERROR, "%s:%zu: Line is longer than %d bytes.", r->path, r->line_number + 1, IMPORT_CHUNK_SIZE);
+            r->failed = true;
+            return false;
+        }
+        memmove(r->buf, r->rest.elems, r->rest.count);
+        size_t n = fread(r->buf + r->rest.count, 1, IMPORT_CHUNK_SIZE - r->rest.count, r->f);
+        if (ferror(r->f)) {
+            noh_log(NOH_ERROR, "Could not read file %s: %s.", r->path, strerror(errno));
+            r->failed = true;
+            return false;
+        }
+        r->eof = n == 0;
+        r->rest.elems = r->buf;
+        r->rest.count += n;
+    }
+}
+
+///////////////////////// Parsing /////////////////////////
+
+static bool sv_is(Noh_String_View sv, const char *cstr) {
+    return noh_sv_eq(sv, noh_sv_from_cstr(cstr));
+}
+
+// Powers of ten that are exact as doubles.
+static const double powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Parses a decimal floating point number, which has to make up the whole word. Digits are collected into an integer
+// and scaled by a power of ten once, which is exact for the numbers found in mesh files, and within a unit in the last
+// place of a float otherwise.
+static bool parse_float(Noh_String_View word, float *out) {
+    const char *c = word.elems;
+    const char *end = word.elems + word.count;
+
+    bool negative = false;
+    if (c < end && (*c == '-' || *c == '+')) negative = *c++ == '-';
+
+    // Digits beyond what fits in the mantissa only affect the exponent.
+    uint64 mantissa = 0;
+    int exponent = 0;
+    size_t digits = 0;
+    for (; c < end && *c >= '0' && *c <= '9'; c++, digits++) {
+        if (mantissa < 100000000000000000ul) mantissa = mantissa * 10 + (*c - '0');
+        else exponent++;
+    }
+    if (c < end && *c == '.') {
+        for (c++; c < end && *c >= '0' && *c <= '9'; c++, digits++) {
+            if (mantissa < 100000000000000000ul) {
+                mantissa = mantissa * 10 + (*c - '0');
+                exponent--;
+            }
+        }
+    }
+    if (digits == 0) return false;
+
+    if (c < end && (*c == 'e' || *c == 'E')) {
+        c++;
+        bool negative_exponent = false;
+        if (c < end && (*c == '-' || *c == '+')) negative_exponent = *c++ == '-';
+        if (c == end || *c < '0' || *c > '9') return false;
+
+        int e = 0;
+        for (; c < end && *c >= '0' && *c <= '9'; c++) e = min(e * 10 + (*c - '0'), 10000);
+        exponent += negative_exponent ? -e : e;
+    }
+    if (c != end) return false;
+
+    double value = (double)mantissa;
+    if (mantissa != 0) {
+        for (; exponent > 22 && value < INFINITY; exponent -= 22) value *= 1e22;
+        for (; exponent < -22 && value > 0; exponent += 22) value /= 1e22;
+        if (exponent > 22 || exponent < -22) exponent = 0;
+        value = exponent >= 0 ? value * powers_of_ten[exponent] : value / powers_of_ten[-exponent];
+    }
+
+    *out = (float)(negative ? -value : value);
+    return true;
+}
+
+// Parses a decimal integer at the start of a word, up to the end of the word or a '/'.
+static bool parse_int(Noh_String_View word, long *out) {
+    const char *c = word.elems;
+    const char *end = word.elems + word.count;
+
+    bool negative = false;
+    if (c < end && (*c == '-' || *c == '+')) negative = *c++ == '-';
+    if (c == end || *c < '0' || *c > '9') return false;
+
+    long value = 0;
+    for (; c < end && *c >= '0' && *c <= '9'; c++) {
+        if (value > (LONG_MAX - 9) / 10) return false;
+        value = value * 10 + (*c - '0');
+    }
+    if (c != end && *c != '/') return false;
+
+    *out = negative ? -value : value;
+    return true;
+}
+
+// Adds a vertex position, dropping z.
+static bool add_vertex(Import_Reader *r, Import_Mesh *mesh, Vector2 position) {
+    if (mesh->positions.count == UINT_MAX) {
+        noh_log(NOH_ERROR, "%s:%zu: More than %u vertices.", r->path, r->line_number, UINT_MAX);
+        return false;
+    }
+    noh_da_append(&mesh->positions, position);
+    return true;
+}
+
+// Adds a polygon as a fan of triangles around its first vertex.
+static void add_polygon(Import_Mesh *mesh, const uint *polygon, size_t count) {
+    for (size_t i = 2; i < count; i++) {
+        noh_da_append(&mesh->indices, polygon[0]);
+        noh_da_append(&mesh->indices, polygon[i - 1]);
+        noh_da_append(&mesh->indices, polygon[i]);
+    }
+}
+
+///////////////////////// OBJ /////////////////////////
+
+// Parses the vertices and faces of an OBJ file, everything else is ignored.
+static bool parse_obj(Import_Reader *r, Import_Mesh *mesh) {
+    bool result = true;
+    Strip_Indices polygon = {0};
+
+    Noh_String_View line;
+    while (next_line(r, &line)) {
+        Noh_String_View keyword = noh_sv_chop_by_space(&line);
+
+        if (sv_is(keyword, "v")) {
+            Vector2 position;
+            if (!parse_float(noh_sv_chop_by_space(&line), &position.x)
+                || !parse_float(noh_sv_chop_by_space(&line), &position.y)) {
+                noh_log(NOH_ERROR, "%s:%zu: Expected a vertex position.", r->path, r->line_number);
+                noh_return_defer(false);
+            }
+            if (!add_vertex(r, mesh, position)) noh_return_defer(false);
+        } else if (sv_is(keyword, "f")) {
+            // Vertices are numbered from 1, negative numbers count back from the last vertex. Texture coordinates and
+            // normals after a '/' are ignored.
+            noh_da_reset(&polygon);
+            for (Noh_String_View word = noh_sv_chop_by_space(&line); word.count > 0;
+                word = noh_sv_chop_by_space(&line)) {
+                long index;
+                if (!parse_int(word, &index)) {
+                    noh_log(NOH_ERROR, "%s:%zu: Expected a vertex number, got '"Nsv_Fmt"'.", r->path, r->line_number,
+                        Nsv_Arg(word));
+                    noh_return_defer(false);
+                }
+                long vertex = index < 0 ? (long)mesh->positions.count + index : index - 1;
+                if (vertex < 0 || vertex >= (long)mesh->positions.count) {
+                    noh_log(NOH_ERROR, "%s:%zu: Vertex %ld does not exist.", r->path, r->line_number, index);
+                    noh_return_defer(false);
+                }
+                noh_da_append(&polygon, (uint)vertex);
+            }
+            if (polygon.count < 3) {
+                noh_log(NOH_ERROR, "%s:%zu: A face needs at least 3 vertices.", r->path, r->line_number);
+                noh_return_defer(false);
+            }
+            add_polygon(mesh, polygon.elems, polygon.count);
+        }
+    }
+    if (r->failed) noh_return_defer(false);
+
+defer:
+    noh_da_free(&polygon);
+    return result;
+}
+
+///////////////////////// PLY /////////////////////////
+
+#define PLY_MAX_ELEMENTS 16
+
+typedef enum { PLY_VERTEX, PLY_FACE, PLY_OTHER } Ply_Kind;
+
+typedef struct {
+    Ply_Kind kind;
+    size_t count;
+    size_t property_count;
+    int x; // The property holding x, for vertices, -1 if there is none.
+    int y;
+    bool indices_first; // For faces, whether the first property is the list of vertex indices.
+} Ply_Element;
+
+// Parses the header of an ASCII PLY file, which lists the elements in the order they appear in.
+static bool parse_ply_header(Import_Reader *r, Ply_Element *elements, size_t *element_count) {
+    Noh_String_View line;
+    if (!next_line(r, &line) || !sv_is(noh_sv_chop_by_space(&line), "ply")) {
+        if (!r->failed) noh_log(NOH_ERROR, "%s is not a PLY file.", r->path);
+        return false;
+    }
+
+    while (next_line(r, &line)) {
+        Noh_String_View keyword = noh_sv_chop_by_space(&line);
+
+        if (sv_is(keyword, "end_header")) {
+            return true;
+        } else if (sv_is(keyword, "format")) {
+            if (!sv_is(noh_sv_chop_by_space(&line), "ascii")) {
+                noh_log(NOH_ERROR, "%s:%zu: Only ASCII PLY files are supported.", r->path, r->line_number);
+                return false;
+            }
+        } else if (sv_is(keyword, "element")) {
+            Noh_String_View name = noh_sv_chop_by_space(&line);
+            long count;
+            if (*element_count == PLY_MAX_ELEMENTS || !parse_int(noh_sv_chop_by_space(&line), &count) || count < 0) {
+                noh_log(NOH_ERROR, "%s:%zu: Invalid element.", r->path, r->line_number);
+                return false;
+            }
+
+            Ply_Element *element = &elements[(*element_count)++];
+            *element = (Ply_Element) { .kind = PLY_OTHER, .count = (size_t)count, .x = -1, .y = -1 };
+            if (sv_is(name, "vertex")) element->kind = PLY_VERTEX;
+            if (sv_is(name, "face")) element->kind = PLY_FACE;
+        } else if (sv_is(keyword, "property")) {
+            if (*element_count == 0) {
+                noh_log(NOH_ERROR, "%s:%zu: Property outside of an element.", r->path, r->line_number);
+                return false;
+            }
+
+            // The name is the last word, after the type or the list types.
+            Ply_Element *element = &elements[*element_count - 1];
+            Noh_String_View name = {0};
+            for (Noh_String_View word = noh_sv_chop_by_space(&line); word.count > 0;
+                word = noh_sv_chop_by_space(&line)) {
+                if (element->property_count == 0 && sv_is(word, "list")) element->indices_first = true;
+                name = word;
+            }
+            if (sv_is(name, "x")) element->x = (int)element->property_count;
+            if (sv_is(name, "y")) element->y = (int)element->property_count;
+            element->property_count++;
+        } else if (!sv_is(keyword, "comment") && !sv_is(keyword, "obj_info") && keyword.count > 0) {
+            noh_log(NOH_ERROR, "%s:%zu: Unknown header line '"Nsv_Fmt"'.", r->path, r->line_number, Nsv_Arg(keyword));
+            return false;
+        }
+    }
+
+    if (!r->failed) noh_log(NOH_ERROR, "%s has no end of header.", r->path);
+    return false;
+}
+
+// Parses the vertices and faces of an ASCII PLY file, everything else is skipped.
+static bool parse_ply(Import_Reader *r, Import_Mesh *mesh) {
+    bool result = true;
+    Strip_Indices polygon = {0};
+    Ply_Element elements[PLY_MAX_ELEMENTS];
+    size_t element_count = 0;
+    if (!parse_ply_header(r, elements, &element_count)) noh_return_defer(false);
+
+    // Faces may come before the vertices, so they are checked against the number of vertices in the header.
+    size_t vertex_count = 0;
+    for (size_t i = 0; i < element_count; i++) {
+        Ply_Element *element = &elements[i];
+        if (element->kind == PLY_VERTEX && (element->x < 0 || element->y < 0)) {
+            noh_log(NOH_ERROR, "%s: Vertices have no x and y.", r->path);
+            noh_return_defer(false);
+        }
+        if (element->kind == PLY_FACE && !element->indices_first) {
+            noh_log(NOH_ERROR, "%s: Faces don't start with a list of vertex indices.", r->path);
+            noh_return_defer(false);
+        }
+        if (element->kind == PLY_VERTEX) vertex_count += element->count;
+    }
+
+    for (size_t i = 0; i < element_count; i++) {
+        Ply_Element *element = &elements[i];
+        for (size_t j = 0; j < element->count; j++) {
+            Noh_String_View line;
+            if (!next_line(r, &line)) {
+                if (!r->failed) noh_log(NOH_ERROR, "%s: File ends before all elements are read.", r->path);
+                noh_return_defer(false);
+            }
+
+            if (element->kind == PLY_VERTEX) {
+                Vector2 position = {0};
+                bool parsed = true;
+                int last = max(element->x, element->y);
+                for (int p = 0; p <= last; p++) {
+                    Noh_String_View word = noh_sv_chop_by_space(&line);
+                    if (p == element->x) parsed = parsed && parse_float(word, &position.x);
+                    if (p == element->y) parsed = parsed && parse_float(word, &position.y);
+                }
+                if (!parsed) {
+                    noh_log(NOH_ERROR, "%s:%zu: Expected a vertex position.", r->path, r->line_number);
+                    noh_return_defer(false);
+                }
+                if (!add_vertex(r, mesh, position)) noh_return_defer(false);
+            } else if (element->kind == PLY_FACE) {
+                long count;
+                if (!parse_int(noh_sv_chop_by_space(&line), &count) || count < 3) {
+                    noh_log(NOH_ERROR, "%s:%zu: A face needs at least 3 vertices.", r->path, r->line_number);
+                    noh_return_defer(false);
+                }
+
+                noh_da_reset(&polygon);
+                for (long k = 0; k < count; k++) {
+                    long index;
+                    if (!parse_int(noh_sv_chop_by_space(&line), &index) || index < 0
+                        || (size_t)index >= vertex_count) {
+                        noh_log(NOH_ERROR, "%s:%zu: Expected %ld vertex indices.", r->path, r->line_number, count);
+                        noh_return_defer(false);
+                    }
+                    noh_da_append(&polygon, (uint)index);
+                }
+                add_polygon(mesh, polygon.elems, polygon.count);
+            }
+        }
+    }
+
+defer:
+    noh_da_free(&polygon);
+    return result;
+}
+
+///////////////////////// Import /////////////////////////
+
+// Returns whether a path ends with the specified extension, ignoring the case.
+static bool has_extension(const char *path, const char *extension) {
+    size_t length = strlen(path);
+    size_t extension_length = strlen(extension);
+    if (length < extension_length) return false;
+
+    Noh_String_View end = { .count = extension_length, .elems = path + length - extension_length };
+    return noh_sv_eq_ci(end, noh_sv_from_cstr(extension));
+}
+
+bool import_is_mesh(const char *path) {
+    return has_extension(path, ".obj") || has_extension(path, ".ply");
+}
+
+// Centers the positions on the origin, scales them to IMPORT_SIZE grid cells and flips y to point down.
+static void fit_to_grid(Import_Positions *positions) {
+    if (positions->count == 0) return;
+
+    Vector2 lo = positions->elems[0];
+    Vector2 hi = positions->elems[0];
+    for (size_t i = 1; i < positions->count; i++) {
+        lo.x = min(lo.x, positions->elems[i].x);
+        lo.y = min(lo.y, positions->elems[i].y);
+        hi.x = max(hi.x, positions->elems[i].x);
+        hi.y = max(hi.y, positions->elems[i].y);
+    }
+
+    float extent = max(hi.x - lo.x, hi.y - lo.y);
+    float scale = extent > 0 ? IMPORT_SIZE / extent : 1;
+    Vector2 center = { (lo.x + hi.x) / 2, (lo.y + hi.y) / 2 };
+    for (size_t i = 0; i < positions->count; i++) {
+        positions->elems[i].x = (positions->elems[i].x - center.x) * scale;
+        positions->elems[i].y = (center.y - positions->elems[i].y) * scale;
+    }
+}
+
+bool import_mesh(Layers *layers, const char *path) {
+    bool result = true;
+    uint64 start = noh_time_ns();
+    Import_Reader reader = { .path = path };
+    Import_Mesh mesh = {0};
+    Strips strips = {0};
+    Strip_Indices stitched = {0};
+
+    reader.f = fopen(path, "rb");
+    if (reader.f == NULL) {
+        noh_log(NOH_ERROR, "Could not open file %s: %s.", path, strerror(errno));
+        noh_return_defer(false);
+    }
+    reader.buf = noh_realloc_check(NULL, IMPORT_CHUNK_SIZE);
+    reader.rest.elems = reader.buf;
+
+    bool parsed = has_extension(path, ".ply") ? parse_ply(&reader, &mesh) : parse_obj(&reader, &mesh);
+    if (!parsed) noh_return_defer(false);
+    if (mesh.indices.count == 0) {
+        noh_log(NOH_ERROR, "%s has no faces.", path);
+        noh_return_defer(false);
+    }
+    uint64 parse_ns = noh_time_ns() - start;
+
+    // All strips go into one layer, so the whole mesh is shown at once.
+    fit_to_grid(&mesh.positions);
+    if (!stripify(&strips, mesh.indices.elems, mesh.indices.count, mesh.positions.count, NULL, 0)) {
+        noh_log(NOH_ERROR, "Could not stripify the faces of %s.", path);
+        noh_return_defer(false);
+    }
+    strips_log_stats(&strips);
+    strips_stitch(&strips, &stitched);
+
+    noh_da_append(layers, strip_to_layer(stitched.elems, stitched.count, mesh.positions.elems));
+
+    double megabytes = (double)ftell(reader.f) / (1 MB);
+    noh_log(NOH_INFO, "Imported %zu vertices and %zu triangles from %s. Parsed in %.3f s (%.0f MB/s), stripified in "
+        "%.3f s.", mesh.positions.count, mesh.indices.count / 3, path, parse_ns / 1e9, megabytes / (parse_ns / 1e9),
+        (noh_time_ns() - start - parse_ns) / 1e9);
+
+defer:
+    if (reader.f) fclose(reader.f);
+    free(reader.buf);
+    noh_da_free(&mesh.positions);
+    noh_da_free(&mesh.indices);
+    strips_free(&strips);
+    noh_da_free(&stitched);
+    return result;
+}
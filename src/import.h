@@ -0,0 +1,25 @@
+#ifndef IMPORT_H_
+#define IMPORT_H_
+
+#include "noh.h"
+#include "points.h"
+
+// Imports triangle meshes from Wavefront OBJ and ASCII PLY files. Files are parsed while they are read in chunks of
+// IMPORT_CHUNK_SIZE, so only the vertices and triangles are kept in memory and never the file itself.
+// Meshes are viewed from the front: z is dropped and y is flipped to point down, which keeps the front faces of the
+// mesh facing front on the screen.
+
+#define IMPORT_CHUNK_SIZE (1 MB)
+
+// The number of grid cells that the largest side of an imported mesh is scaled to.
+#define IMPORT_SIZE 10
+
+// Indicates whether a path has the extension of a mesh file that can be imported.
+bool import_is_mesh(const char *path);
+
+// Imports a mesh file, stripifies its triangles and appends them as a single layer of strips joined by degenerate
+// triangles. The mesh is centered on the origin and scaled to IMPORT_SIZE grid cells. Polygons are split into fans.
+// Returns whether the file could be read and parsed.
+bool import_mesh(Layers *layers, const char *path);
+
+#endif // IMPORT_H_
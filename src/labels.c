@@ -0,0 +1,101 @@
+#include "labels.h"
+#include <rlgl.h>
+
+// Padding around every glyph in the atlas, so filtering does not bleed neighbouring glyphs in.
+#define LABEL_GLYPH_PADDING 2
+
+Label_Cache label_cache_load(int font_size) {
+    Label_Cache cache = {0};
+    Font font = GetFontDefault();
+
+    // Use the same spacing that DrawText uses for the default font.
+    cache.spacing = font_size / 10;
+    cache.height = font_size;
+
+    // Measure all digits to determine the size of the atlas.
+    float atlas_width = LABEL_GLYPH_PADDING;
+    for (int d = 0; d < 10; d++) {
+        char digit[2] = { '0' + d, '\0' };
+        cache.widths[d] = MeasureTextEx(font, digit, font_size, cache.spacing).x;
+        atlas_width += cache.widths[d] + LABEL_GLYPH_PADDING;
+    }
+
+    // Draw the digits next to each other.
+    Image image = GenImageColor((int)atlas_width + 1, font_size + 2 * LABEL_GLYPH_PADDING, BLANK);
+    float x = LABEL_GLYPH_PADDING;
+    for (int d = 0; d < 10; d++) {
+        char digit[2] = { '0' + d, '\0' };
+        Vector2 pos = { .x = x, .y = LABEL_GLYPH_PADDING };
+        ImageDrawTextEx(&image, font, digit, pos, font_size, cache.spacing, WHITE);
+        cache.glyphs[d] = (Rectangle) { .x = x, .y = LABEL_GLYPH_PADDING, .width = cache.widths[d], .height = font_size };
+        x += cache.widths[d] + LABEL_GLYPH_PADDING;
+    }
+
+    cache.atlas = LoadTextureFromImage(image);
+    UnloadImage(image);
+    return cache;
+}
+
+void label_cache_unload(Label_Cache *cache) {
+    UnloadTexture(cache->atlas);
+    cache->atlas.id = 0;
+}
+
+size_t label_format(char *buf, size_t number) {
+    // Write the digits backwards into a temporary buffer, then copy them in order.
+    char temp[LABEL_MAX_DIGITS];
+    size_t n = 0;
+    do {
+        temp[n++] = '0' + number % 10;
+        number /= 10;
+    } while (number > 0);
+
+    for (size_t i = 0; i < n; i++) buf[i] = temp[n - 1 - i];
+    return n;
+}
+
+// Measures a formatted label from the cached digit widths.
+static Vector2 measure_digits(Label_Cache *cache, char *digits, size_t n) {
+    Vector2 result = { .x = cache->spacing * (n - 1), .y = cache->height };
+    for (size_t i = 0; i < n; i++) result.x += cache->widths[digits[i] - '0'];
+    return result;
+}
+
+void label_draw_indexes(Label_Cache *cache, Vector2 *positions, size_t count, Vector2 offset, Color color) {
+    if (count == 0) return;
+
+    float atlas_w = cache->atlas.width;
+    float atlas_h = cache->atlas.height;
+
+    rlSetTexture(cache->atlas.id);
+    rlBegin(RL_QUADS);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlNormal3f(0.0, 0.0, 1.0);
+
+    for (size_t i = 0; i < count; i++) {
+        char digits[LABEL_MAX_DIGITS];
+        size_t n = label_format(digits, i);
+
+        // Center the label on the anchor.
+        Vector2 size = measure_digits(cache, digits, n);
+        float x = positions[i].x + offset.x - size.x / 2;
+        float y = positions[i].y + offset.y - size.y / 2;
+
+        for (size_t j = 0; j < n; j++) {
+            Rectangle src = cache->glyphs[digits[j] - '0'];
+            float u0 = src.x / atlas_w, u1 = (src.x + src.width) / atlas_w;
+            float v0 = src.y / atlas_h, v1 = (src.y + src.height) / atlas_h;
+
+            // Same vertex order as DrawTexturePro.
+            rlTexCoord2f(u0, v0); rlVertex2f(x, y);
+            rlTexCoord2f(u0, v1); rlVertex2f(x, y + src.height);
+            rlTexCoord2f(u1, v1); rlVertex2f(x + src.width, y + src.height);
+            rlTexCoord2f(u1, v0); rlVertex2f(x + src.width, y);
+
+            x += src.width + cache->spacing;
+        }
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+}
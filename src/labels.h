@@ -0,0 +1,34 @@
+#ifndef LABELS_H_
+#define LABELS_H_
+
+#include <raylib.h>
+#include "noh.h"
+
+// A cache for drawing many numeric labels. The digits are rendered once into an atlas texture with their sizes
+// measured, so drawing a label needs no formatting, no measuring and no texture switches.
+
+#define LABEL_MAX_DIGITS 20
+
+typedef struct {
+    Texture2D atlas;
+    Rectangle glyphs[10]; // Where each digit is in the atlas.
+    float widths[10]; // The advance of each digit, in pixels.
+    float spacing; // Space between digits, in pixels.
+    float height;
+} Label_Cache;
+
+// Renders the digits of the default font at the specified size into an atlas. Requires an OpenGL context.
+Label_Cache label_cache_load(int font_size);
+
+// Unloads the atlas of a label cache.
+void label_cache_unload(Label_Cache *cache);
+
+// Writes the decimal digits of a number into a buffer of at least LABEL_MAX_DIGITS characters, without a
+// terminating null. Returns the number of digits written.
+size_t label_format(char *buf, size_t number);
+
+// Draws the index of every position as a label, centered at the position moved by the offset. All labels are
+// submitted as one textured batch.
+void label_draw_indexes(Label_Cache *cache, Vector2 *positions, size_t count, Vector2 offset, Color color);
+
+#endif // LABELS_H_
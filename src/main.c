@@ -2,6 +2,17 @@
 #include <raylib.h>
 #include <raymath.h>
 
+#include "points.h"
+#include "transform.h"
+#include "strip.h"
+#include "labels.h"
+#include "profiler.h"
+#include "raster.h"
+#include "stripify.h"
+#include "vcache.h"
+#include "session.h"
+#include "import.h"
+
 #define NOH_IMPLEMENTATION
 #include "noh.h"
 
@@ -18,22 +29,13 @@
 #define POINT_NUMBER_COLOR ORANGE
 #define CONNECTION_COLOR CLITERAL(Color) { 0, 64, 255, 255 }
 
-typedef struct {
-    Vector2 *elems;
-    size_t count;
-    size_t capacity;
-} Points;
-
-typedef struct {
-    Points *elems;
-    size_t count;
-    size_t capacity;
-
-    size_t active_layer;
-    int comparison_layer; // I want to use -1 to indicate no comparison.
-} Layers;
+const Layer_Colors LAYER_COLORS = {
+    .fill = TRIANGLE_STRIP_COLOR, .lines = TRIANGLE_LINES_COLOR, .points = POINT_NORMAL_COLOR
+};
 
 const int GRID_SPACING = 50;
+const int VCACHE_SIZE = 16;
+const int POINT_NUMBER_FONT_SIZE = 29;
 
 typedef enum {
     Align_Top_Left, Align_Top_Right, Align_Top_Center,
@@ -129,192 +131,237 @@ void draw_grid_and_axes(Vector2 center) {
 }
 
 void draw_mouse_pos(Noh_Arena *arena, Vector2 mouse, float x, float y) {
-    noh_arena_save(arena);
-    char *text = noh_arena_sprintf(arena, "%i, %i", (int)mouse.x, (int)mouse.y);
-    draw_text(text, Align_Top_Right, 20, x, y, LIME);
-    noh_arena_rewind(arena);
-}
-
-void draw_number(Noh_Arena *arena, Vector2 pos, int number, Color color, bool other_side) {
-    noh_arena_save(arena);
-    char *text = noh_arena_sprintf(arena, "%i", number);
-    Vector2 text_pos = Vector2Add(pos, CLITERAL(Vector2) { 15, -15 });
-    if (other_side) text_pos = Vector2Subtract(pos, CLITERAL(Vector2) { 15, -15 }); 
-    draw_text(text, Align_Middle_Center, 29, text_pos.x, text_pos.y, color);
-    noh_arena_rewind(arena);
+    noh_arena_temp(arena) {
+        char *text = noh_arena_sprintf(arena, "%i, %i", (int)mouse.x, (int)mouse.y);
+        draw_text(text, Align_Top_Right, 20, x, y, LIME);
+    }
 }
 
-// Draw a number near a grid point.
-void draw_grid_number(Noh_Arena *arena, Vector2 center, Vector2 pos, int number, Color color, bool other_side) {
-    draw_number(arena, grid_to_screen(center, pos), number, color, other_side);
+void draw_animation_ms(Noh_Arena *arena, size_t duration, float x, float y) {
+    noh_arena_temp(arena) {
+        char *text = noh_arena_sprintf(arena, "Animation: %zums", duration);
+        draw_text(text, Align_Top_Left, 20, x, y, LIME);
+    }
 }
 
-void draw_animation_ms(Noh_Arena *arena, size_t duration, float x, float y) {
-    noh_arena_save(arena);
-    char *text = noh_arena_sprintf(arena, "Animation: %zums", duration);
-    draw_text(text, Align_Top_Left, 20, x, y, LIME);
-    noh_arena_rewind(arena);
+// The vertex cache miss ratios of a layer, kept until the layer changes.
+typedef struct {
+    bool valid;
+    size_t layer;
+    size_t version;
+    double fifo;
+    double lru;
+} Layer_Acmr;
+
+void update_layer_acmr(Noh_Arena *arena, Layer_Acmr *acmr, Layers *layers) {
+    Points *points = &layers->elems[layers->active_layer];
+    noh_assert(!points->compact && "Compact layers are expanded before they are drawn");
+    if (acmr->valid && acmr->layer == layers->active_layer && acmr->version == points->version) return;
+
+    Noh_Arena_Mark mark = noh_arena_mark(arena);
+    uint *ids = noh_arena_push(arena, uint, points->count);
+    points_vertex_ids(points, ids);
+    acmr->fifo = vcache_acmr(ids, points->count, true, VCACHE_FIFO, VCACHE_SIZE);
+    acmr->lru = vcache_acmr(ids, points->count, true, VCACHE_LRU, VCACHE_SIZE);
+    noh_arena_rewind_to(arena, mark);
+
+    acmr->valid = true;
+    acmr->layer = layers->active_layer;
+    acmr->version = points->version;
 }
 
-void draw_active_layer(Noh_Arena *arena, Layers *layers, float x, float y) {
-    noh_arena_save(arena);
-    char *text = noh_arena_sprintf(arena, "Layer: %zu", layers->active_layer);
-    draw_text(text, Align_Top_Left, 20, x, y, LIME);
-    noh_arena_rewind(arena);
+void draw_active_layer(Noh_Arena *arena, Layers *layers, Layer_Acmr *acmr, float x, float y) {
+    noh_arena_temp(arena) {
+        char *text = noh_arena_sprintf(arena, "Layer: %zu (ACMR %.2f %s, %.2f %s)", layers->active_layer, acmr->fifo,
+            vcache_policy_name(VCACHE_FIFO), acmr->lru, vcache_policy_name(VCACHE_LRU));
+        draw_text(text, Align_Top_Left, 20, x, y, LIME);
+    }
 }
 
 void draw_comparison_layer(Noh_Arena *arena, Layers *layers, float x, float y) {
     if (layers->comparison_layer == -1) return;
 
-    noh_arena_save(arena);
-    char *text = noh_arena_sprintf(arena, "Compare: %zu", layers->comparison_layer);
-    draw_text(text, Align_Top_Left, 20, x, y, LIME);
-    noh_arena_rewind(arena);
+    noh_arena_temp(arena) {
+        char *text = noh_arena_sprintf(arena, "Compare: %zu", layers->comparison_layer);
+        draw_text(text, Align_Top_Left, 20, x, y, LIME);
+    }
 }
 
-void add_point(Points *points, Vector2 pos) {
-    bool point_exists = false;
-    for (size_t i = 0; i < points->count; i++) {
-        if (points->elems[i].x == pos.x && points->elems[i].y == pos.y) {
-            point_exists = true;
-            break;
-        }
+void draw_draw_calls_saved(Noh_Arena *arena, size_t saved, float x, float y) {
+    noh_arena_temp(arena) {
+        char *text = noh_arena_sprintf(arena, "Draw calls saved: %zu", saved);
+        draw_text(text, Align_Top_Left, 20, x, y, LIME);
     }
-
-    if (point_exists) return;
-
-    Vector2 new_point = { .x = pos.x, .y = pos.y };
-    noh_da_append(points, new_point);
 }
 
-void remove_point(Points *points, Vector2 pos) {
-    int point_index = -1;
-    for (size_t i = 0; i < points->count; i++) {
-        if (points->elems[i].x == pos.x && points->elems[i].y == pos.y) {
-            point_index = (int)i;
-            break;
-        }
+void switch_to_next_layer(Layers *layers) {
+    if (layers->active_layer == layers->count - 1) {
+        if (layers->elems[layers->active_layer].count == 0) return;
+        Points new_points = {0};
+        noh_da_append(layers, new_points);
     }
 
-    if (point_index == -1) return;
-
-    noh_da_remove_at(points, (size_t)point_index);
+    layers->active_layer++;
 }
 
-int start_moving(Points *points, Vector2 pos) {
-    for (size_t i = 0; i < points->count; i++) {
-        if (points->elems[i].x == pos.x && points->elems[i].y == pos.y) {
-            return (int)i;
+void switch_to_previous_layer(Layers *layers) {
+    if (layers->active_layer == 0) return;
+
+    if (layers->active_layer == layers->count - 1) {
+        if (layers->elems[layers->active_layer].count == 0) {
+            layer_mesh_unload(&layers->elems[layers->active_layer].mesh);
+            points_free(&layers->elems[layers->active_layer]);
+            layers->count--;
         }
     }
-
-    return -1;
+    layers->active_layer--;
 }
 
-void stop_moving(Points *points, int moving_index, Vector2 pos) {
-    bool point_exists = false;
-    for (size_t i = 0; i < points->count; i++) {
-        if (points->elems[i].x == pos.x && points->elems[i].y == pos.y) {
-            point_exists = true;
-            break;
-        }
+/// Expands the active and comparison layer if they are compact, which is needed before they are edited or drawn.
+void expand_shown_layers(Layers *layers) {
+    points_expand(&layers->elems[layers->active_layer]);
+    if (layers->comparison_layer >= 0 && layers->comparison_layer < (int)layers->count) {
+        points_expand(&layers->elems[layers->comparison_layer]);
     }
-
-    // If there is already another point at the target position, don't do anything.
-    if (point_exists) return;
-
-    points->elems[moving_index].x = pos.x;
-    points->elems[moving_index].y = pos.y;
 }
 
-void move_point_index(Points *points, Vector2 pos, int direction) {
-    int point_index = -1;
-    for (size_t i = 0; i < points->count; i++) {
-        if (points->elems[i].x == pos.x && points->elems[i].y == pos.y) {
-            point_index = (int)i;
-            break;
+/// Compacts all layers that are not shown, to save memory. They are expanded again once they are shown.
+void compact_hidden_layers(Layers *layers) {
+    size_t before = 0, after = 0, compacted = 0, skipped = 0;
+    for (size_t i = 0; i < layers->count; i++) {
+        Points *points = &layers->elems[i];
+        if (i == layers->active_layer || (int)i == layers->comparison_layer) continue;
+        // Mapped layers don't use any heap memory until they are edited.
+        if (points->compact || points->mapped || points->count == 0) continue;
+
+        before += points_memory(points);
+        if (points_compact(points)) {
+            layer_mesh_unload(&points->mesh);
+            compacted++;
+        } else {
+            skipped++;
         }
+        after += points_memory(points);
     }
 
-    if (point_index == -1) return;
-    if (point_index + direction < 0) return;
-    if (point_index + direction >= (int)points->count) return;
-
-    Vector2 temp = points->elems[point_index];
-    points->elems[point_index] = points->elems[point_index + direction];
-    points->elems[point_index + direction] = temp;
+    noh_log(NOH_INFO, "Compacted %zu layers from %zu to %zu bytes, %zu layers with points off the grid are skipped.",
+        compacted, before, after, skipped);
 }
 
-void switch_to_next_layer(Layers *layers) {
-    if (layers->active_layer == layers->count - 1) {
-        if (layers->elems[layers->active_layer].count == 0) return;
-        Points new_points = {0};
-        noh_da_append(layers, new_points);
+/// Reorders the triangles of the active layer for the vertex cache, and adds them as a new layer of short strips joined
+/// by degenerate triangles, which becomes the active layer. The triangles themselves stay the same.
+void optimize_active_layer(Noh_Arena *arena, Layers *layers) {
+    Points *points = &layers->elems[layers->active_layer];
+    if (points->count < 3) return;
+
+    Noh_Arena_Mark mark = noh_arena_mark(arena);
+    uint *ids = noh_arena_push(arena, uint, points->count);
+    points_vertex_ids(points, ids);
+    uint *triangles = noh_arena_push(arena, uint, 3 * (points->count - 2));
+    size_t triangle_count = strip_to_triangles(ids, points->count, triangles);
+    if (triangle_count == 0) {
+        noh_arena_rewind_to(arena, mark);
+        return;
     }
-
-    layers->active_layer++;
-}
-
-void switch_to_previous_layer(Layers *layers) {
-    if (layers->active_layer == 0) return;
-
-    if (layers->active_layer == layers->count - 1) {
-        if (layers->elems[layers->active_layer].count == 0) layers->count--;
+    uint *order = noh_arena_push(arena, uint, triangle_count + 1);
+    vcache_tipsify(triangles, 3 * triangle_count, points->count, VCACHE_SIZE, order);
+
+    // Strips that stay within half a cache of the optimized order keep most of its vertex reuse.
+    Strips strips = {0};
+    Strip_Indices stitched = {0};
+    stripify(&strips, triangles, 3 * triangle_count, points->count, order, VCACHE_SIZE / 2);
+    strips_stitch(&strips, &stitched);
+
+    Points optimized = strip_to_layer(stitched.elems, stitched.count, points->elems);
+    noh_log(NOH_INFO, "Optimized layer %zu for a %s vertex cache of %d: ACMR %.3f -> %.3f, %zu -> %zu points.",
+        layers->active_layer, vcache_policy_name(VCACHE_FIFO), VCACHE_SIZE,
+        vcache_acmr(ids, points->count, true, VCACHE_FIFO, VCACHE_SIZE),
+        vcache_acmr(stitched.elems, stitched.count, true, VCACHE_FIFO, VCACHE_SIZE), points->count, optimized.count);
+
+    // Take the place of an empty last layer, there should only ever be one at the end.
+    Points *last = &layers->elems[layers->count - 1];
+    if (last->count == 0) {
+        layer_mesh_unload(&last->mesh);
+        points_free(last);
+        *last = optimized;
+    } else {
+        noh_da_append(layers, optimized);
     }
-    layers->active_layer--;
+    layers->active_layer = layers->count - 1;
+
+    strips_free(&strips);
+    noh_da_free(&stitched);
+    noh_arena_rewind_to(arena, mark);
 }
 
 Vector2 *translate_points_to_screen(Noh_Arena *arena, Vector2 center, Points *points, size_t count) {
     noh_assert(count >= points->count && "Count is lower than points count");
-    Vector2 *result = noh_arena_alloc(arena, sizeof(Vector2) * count);
-    for (size_t i = 0; i < count; i++) {
-        int j = min(points->count - 1, i);
-        result[i] = grid_to_screen(center, points->elems[j]);
-    }
+    noh_assert(!points->compact && "Compact layers are expanded before they are drawn");
+    Vector2 *result = noh_arena_push(arena, Vector2, count);
+    if (points->count == 0) return result;
+
+    transform_scale_offset(result, points->elems, points->count, GRID_SPACING, center);
+
+    // Any points beyond the points in the layer repeat the last point.
+    for (size_t i = points->count; i < count; i++) result[i] = result[points->count - 1];
     return result;
 }
 
 Vector2 *lerp_points(Noh_Arena *arena, Vector2 *from, Vector2 *to, float factor, size_t count) {
-    Vector2 *result = noh_arena_alloc(arena, sizeof(Vector2) * count);
-    for (size_t i = 0; i < count; i++) {
-        result[i] = Vector2Lerp(from[i], to[i], factor);
-    }
-
+    Vector2 *result = noh_arena_push(arena, Vector2, count);
+    transform_lerp(result, from, to, count, factor);
     return result;
 }
 
-void draw_layer(Noh_Arena *arena, Vector2 center, int moving_index, Points *points, bool comparison) {
-    Color triStripColor = comparison ? ColorBrightness(TRIANGLE_STRIP_COLOR, -0.85) : TRIANGLE_STRIP_COLOR;
-    Color triLinesColor = comparison ? ColorBrightness(TRIANGLE_LINES_COLOR, -0.85) : TRIANGLE_LINES_COLOR;
-    Color pointColor = comparison ? ColorBrightness(POINT_NORMAL_COLOR, -0.85) : POINT_NORMAL_COLOR;
+/// Draws what is drawn on top of a layer: the point being dragged and the numbers of the points.
+void draw_layer_overlay(Noh_Arena *arena, Label_Cache *labels, Vector2 center, int moving_index, Points *points,
+    bool comparison) {
     Color pointNumberColor = comparison ? ColorBrightness(POINT_NUMBER_COLOR, -0.85) : POINT_NUMBER_COLOR;
 
-    // Calculate points of active layer.
-    noh_arena_save(arena);
+    // Draw the point being dragged on top.
+    if (!comparison && moving_index >= 0 && moving_index < (int)points->count) {
+        DrawCircleV(grid_to_screen(center, points->elems[moving_index]), 7, POINT_DRAGGING_COLOR);
+    }
+
+    // Draw numbers of the layer, next to the points. Comparison layers have them on the other side.
+    Noh_Arena_Mark mark = noh_arena_mark(arena);
     Vector2 *screen_points = translate_points_to_screen(arena, center, points, points->count);
+    Vector2 number_offset = comparison ? CLITERAL(Vector2) { -15, 15 } : CLITERAL(Vector2) { 15, -15 };
+    label_draw_indexes(labels, screen_points, points->count, number_offset, pointNumberColor);
+    noh_arena_rewind_to(arena, mark);
+}
 
-    // Draw triangle strip of active layer
-    DrawTriangleStrip(screen_points, points->count, triStripColor);
+void draw_layer(Noh_Arena *arena, Label_Cache *labels, Vector2 center, int moving_index, Points *points, bool comparison) {
+    Color tint = comparison ? ColorBrightness(WHITE, -0.85) : WHITE;
+    noh_assert(!points->compact && "Compact layers are expanded before they are drawn");
 
-    // Draw lines between points of active layer.
-    for (size_t i = 1; i < points->count; i++) {
-        DrawLineV(screen_points[i-1], screen_points[i], triLinesColor);
+    // Rebuild the mesh only if the layer changed since it was last uploaded.
+    if (layer_mesh_is_stale(&points->mesh, points->version)) {
+        layer_mesh_update(arena, &points->mesh, points->elems, points->count, points->version, GRID_SPACING,
+            LAYER_COLORS);
     }
 
-    // Draw points and numbers of active layer.
-    for (size_t i = 0; i < points->count; i++) {
-        if ((int)i == moving_index && !comparison) {
-            DrawCircleV(screen_points[i], 7, POINT_DRAGGING_COLOR);
-        } else {
-            DrawCircleV(screen_points[i], 5, pointColor);
-        }
-        draw_grid_number(arena, center, points->elems[i], i, pointNumberColor, comparison);
-    }
+    // Draw triangle strip, lines between points and points of the layer.
+    layer_mesh_draw(&points->mesh, center, tint);
+    draw_layer_overlay(arena, labels, center, moving_index, points, comparison);
+}
 
-    noh_arena_rewind(arena);
+/// Appends a layer to a stitched strip, in the colors that draw_layer would draw it with.
+void stitch_visible_layer(Stitched_Strip *stitched, Vector2 center, Points *points, bool comparison) {
+    noh_assert(!points->compact && "Compact layers are expanded before they are drawn");
+    Layer_Colors colors = LAYER_COLORS;
+    if (comparison) {
+        Color tint = ColorBrightness(WHITE, -0.85);
+        colors.fill = ColorTint(colors.fill, tint);
+        colors.lines = ColorTint(colors.lines, tint);
+        colors.points = ColorTint(colors.points, tint);
+    }
+    stitch_layer(stitched, points->elems, points->count, GRID_SPACING, center, colors);
 }
 
 void draw_connections(Vector2 center, Points *active, Points *comparison) {
+    noh_assert(!active->compact && "Compact layers are expanded before they are drawn");
+    noh_assert(!comparison->compact && "Compact layers are expanded before they are drawn");
     size_t no_connections = min(active->count, comparison->count);
     if (no_connections == 0) return;
 
@@ -326,8 +373,9 @@ void draw_connections(Vector2 center, Points *active, Points *comparison) {
     }
 }
 
-bool draw_animation(Noh_Arena *arena, Vector2 center, float *animation_time, Points *from, Points *to, size_t duration) {
-    float ft = GetFrameTime();
+bool draw_animation(Noh_Arena *arena, Label_Cache *labels, Vector2 center, float *animation_time, Points *from, Points *to, size_t duration) {
+    // The first frame after waiting for input reports the whole wait as frame time, don't let it skip the animation.
+    float ft = min(GetFrameTime(), 1.0f / 30);
     if(*animation_time <= 0.0) {
         *animation_time = 0.0;
         return false;
@@ -336,57 +384,232 @@ bool draw_animation(Noh_Arena *arena, Vector2 center, float *animation_time, Poi
 
     size_t total_points = max(from->count, to->count);
     size_t shared_points = min(from->count, to->count);
-    noh_arena_save(arena);
+    Noh_Arena_Mark mark = noh_arena_mark(arena);
     Vector2 *from_screen = translate_points_to_screen(arena, center, from, total_points);
     Vector2 *to_screen = translate_points_to_screen(arena, center, to, total_points);
     Vector2 *int_screen = lerp_points(arena, from_screen, to_screen, *animation_time, total_points);
 
-    DrawTriangleStrip(int_screen, total_points, TRIANGLE_STRIP_COLOR);
+    draw_triangle_strip_chunked(int_screen, total_points, TRIANGLE_STRIP_COLOR);
     for (size_t i = 1; i < shared_points; i++) {
         DrawLineV(int_screen[i-1], int_screen[i], TRIANGLE_LINES_COLOR);
     }
     for (size_t i = 0; i < shared_points; i++) {
         DrawCircleV(int_screen[i], 5, POINT_NORMAL_COLOR);
-        draw_number(arena, int_screen[i], i, POINT_NUMBER_COLOR, false);
     }
+    label_draw_indexes(labels, int_screen, shared_points, CLITERAL(Vector2) { 15, -15 }, POINT_NUMBER_COLOR);
 
-    noh_arena_rewind(arena);
+    noh_arena_rewind_to(arena, mark);
 
     return true;
 }
 
-int main() {
+// Everything that determines what the scene looks like, except for the contents of the layers which are tracked by
+// their versions. The scene is only redrawn when this changes.
+typedef struct {
+    Vector2 screen_size;
+    Vector2 mouse;
+    size_t layer_count;
+    size_t active_layer;
+    int comparison_layer;
+    size_t active_version;
+    size_t comparison_version;
+    int moving_index;
+    size_t animation_ms;
+    bool animating;
+    bool stitching;
+} Redraw_State;
+
+bool redraw_state_eq(Redraw_State *a, Redraw_State *b) {
+    return a->screen_size.x == b->screen_size.x && a->screen_size.y == b->screen_size.y
+        && a->mouse.x == b->mouse.x && a->mouse.y == b->mouse.y
+        && a->layer_count == b->layer_count
+        && a->active_layer == b->active_layer
+        && a->comparison_layer == b->comparison_layer
+        && a->active_version == b->active_version
+        && a->comparison_version == b->comparison_version
+        && a->moving_index == b->moving_index
+        && a->animation_ms == b->animation_ms
+        && a->animating == b->animating
+        && a->stitching == b->stitching;
+}
+
+// Layers can be large, the arena only uses memory for what is allocated in it.
+#define ARENA_RESERVE ((size_t)4 GB)
+
+#define HEADLESS_WIDTH 800
+#define HEADLESS_HEIGHT 600
+
+/// Adds the grid and axes to a raster scene, the same way draw_grid_and_axes draws them.
+void raster_grid_and_axes(Noh_Arena *arena, Raster_Scene *scene, Vector2 center) {
+    int x_steps = floorf(center.x / GRID_SPACING);
+    int y_steps = floorf(center.y / GRID_SPACING);
+
+    Noh_Arena_Mark mark = noh_arena_mark(arena);
+    size_t line_count = (2*y_steps + 1) + (2*x_steps + 1) + 2;
+    Geometry_Vertex *vertices = noh_arena_push(arena, Geometry_Vertex, 6 * line_count);
+    Geometry_Vertex *v = vertices;
+
+    // Rows
+    for (int row = 0; row <= 2*y_steps; row++)
+        v = geometry_push_line(v,
+            grid_to_screen_p(center, -x_steps, row - y_steps),
+            grid_to_screen_p(center, x_steps, row - y_steps),
+            1, GRID_COLOR);
+    // Cols
+    for (int col = 0; col <= 2*x_steps; col++)
+        v = geometry_push_line(v,
+            grid_to_screen_p(center, col - x_steps, -y_steps),
+            grid_to_screen_p(center, col - x_steps, y_steps),
+            1, GRID_COLOR);
+    // x-axis
+    v = geometry_push_line(v,
+        grid_to_screen_p(center, -x_steps, 0),
+        grid_to_screen_p(center,  x_steps, 0),
+        1, X_AXIS_COLOR);
+    // y-axis
+    v = geometry_push_line(v,
+        grid_to_screen_p(center, 0, -y_steps),
+        grid_to_screen_p(center, 0, y_steps),
+        1, Y_AXIS_COLOR);
+
+    raster_scene_add(scene, vertices, v - vertices);
+    noh_arena_rewind_to(arena, mark);
+}
+
+/// Renders all layers in a text file, or an imported mesh, on top of each other into a PNG, without a window or a GPU.
+bool render_headless(const char *input_path, const char *output_path) {
+    bool result = true;
+    Noh_Arena arena = noh_arena_init_virtual(ARENA_RESERVE);
+    Layers layers = {0};
+    Image image = raster_image_alloc(HEADLESS_WIDTH, HEADLESS_HEIGHT, BACKGROUND_COLOR);
+    Raster_Scene scene = raster_scene_init(HEADLESS_WIDTH, HEADLESS_HEIGHT);
+    Vector2 center = { HEADLESS_WIDTH / 2, HEADLESS_HEIGHT / 2 };
+
+    bool loaded = import_is_mesh(input_path) ? import_mesh(&layers, input_path) : layers_load_text(&layers, input_path);
+    if (!loaded) noh_return_defer(false);
+
+    // Everything is binned first, then all tiles are rasterized in parallel.
+    raster_grid_and_axes(&arena, &scene, center);
+    for (size_t i = 0; i < layers.count; i++) {
+        Points *points = &layers.elems[i];
+        size_t vertex_count = layer_geometry_vertex_count(points->count);
+
+        Noh_Arena_Mark mark = noh_arena_mark(&arena);
+        Geometry_Vertex *vertices = noh_arena_push(&arena, Geometry_Vertex, vertex_count);
+        layer_geometry_build(vertices, points->elems, points->count, GRID_SPACING, center, LAYER_COLORS);
+        raster_scene_add(&scene, vertices, vertex_count);
+        noh_arena_rewind_to(&arena, mark);
+    }
+    raster_scene_draw(&scene, &image, raster_thread_count());
+
+    if (!ExportImage(image, output_path)) {
+        noh_log(NOH_ERROR, "Could not write image %s.", output_path);
+        noh_return_defer(false);
+    }
+
+defer:
+    UnloadImage(image);
+    raster_scene_free(&scene);
+    layers_free(&layers);
+    noh_arena_free(&arena);
+    return result;
+}
+
+#define TRACE_CAPACITY (1 << 18)
+
+int main(int argc, char **argv) {
+    noh_shift_args(&argc, &argv);
+
+    // Usage: --trace <path> to write a Chrome trace of all frames to the specified path on exit.
+    // Usage: --headless <layers.txt|mesh.obj|mesh.ply> <image.png> to render the layers in a text file, or an imported
+    // mesh, to an image and exit.
+    // Usage: --session <path> to load the layers from a session file if it exists, and save them to it on exit.
+    // Usage: --import <mesh.obj|mesh.ply> to add the triangles of a mesh as a new layer of strips.
+    char *trace_path = NULL;
+    char *session_path = NULL;
+    char *import_path = NULL;
+    char *headless_input = NULL;
+    char *headless_output = NULL;
+    while (argc > 0) {
+        char *option = noh_shift_args(&argc, &argv);
+        if (strcmp(option, "--trace") == 0 && argc >= 1) {
+            trace_path = noh_shift_args(&argc, &argv);
+        } else if (strcmp(option, "--headless") == 0 && argc >= 2) {
+            headless_input = noh_shift_args(&argc, &argv);
+            headless_output = noh_shift_args(&argc, &argv);
+        } else if (strcmp(option, "--session") == 0 && argc >= 1) {
+            session_path = noh_shift_args(&argc, &argv);
+        } else if (strcmp(option, "--import") == 0 && argc >= 1) {
+            import_path = noh_shift_args(&argc, &argv);
+        } else {
+            noh_log(NOH_ERROR, "Unknown or incomplete option %s.", option);
+            return 1;
+        }
+    }
+    if (trace_path != NULL) noh_trace_init(TRACE_CAPACITY);
+
+    if (headless_input != NULL) {
+        bool rendered = render_headless(headless_input, headless_output);
+        if (trace_path != NULL) {
+            noh_trace_write(trace_path);
+            noh_trace_free();
+        }
+        return rendered ? 0 : 1;
+    }
+
+    // A session that exists but can't be loaded is not overwritten on exit.
+    Session session = {0};
+    Layers layers = {0};
+    layers.comparison_layer = -1;
+    struct stat session_stat;
+    if (session_path != NULL && stat(session_path, &session_stat) == 0) {
+        if (!session_load(&session, &layers, session_path)) return 1;
+        noh_log(NOH_INFO, "Loaded %zu layers from %s.", layers.count, session_path);
+    } else {
+        Points points = {0};
+        noh_da_append(&layers, points);
+    }
+
+    // The imported mesh takes the place of an empty last layer, and becomes the active layer.
+    if (import_path != NULL) {
+        if (layers.elems[layers.count - 1].count == 0) points_free(&layers.elems[--layers.count]);
+        if (!import_mesh(&layers, import_path)) return 1;
+        layers.active_layer = layers.count - 1;
+    }
+
     SetTargetFPS(60);
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(800, 600, "Triangle strip visualizer");
     SetWindowMonitor(0);
-
-    Noh_Arena arena = noh_arena_init(1 KB);
-    Layers layers = {0};
-    layers.comparison_layer = -1;
-    Points points = {0};
-    noh_da_append(&layers, points);
+    layer_mesh_init();
+    Label_Cache labels = label_cache_load(POINT_NUMBER_FONT_SIZE);
+    profiler_init(240);
+
+    Noh_Arena arena = noh_arena_init_virtual(ARENA_RESERVE);
+
+    // The scene is drawn into a texture, which is shown as is while nothing changes. While idle, the loop blocks
+    // until there is input.
+    RenderTexture2D scene = {0};
+    Redraw_State drawn_state = {0};
+    bool event_waiting = false;
+    bool show_profiler = false;
+    bool show_arena_stats = false;
+    bool stitching = false;
+    Layer_Acmr acmr = {0};
 
     while (!WindowShouldClose()) {
+        noh_trace_begin("frame");
+        noh_arena_stats_frame(&arena);
         Vector2 screen_size = get_screen_size();
         Vector2 screen_center = Vector2Scale(screen_size, 0.5);
         Vector2 mouse = screen_to_grid(screen_center, GetMousePosition());
-
-        BeginDrawing();
-        ClearBackground(BACKGROUND_COLOR);
-
-        // Hud
-        draw_grid_and_axes(screen_center);
-        DrawFPS(10, 10);
-        draw_mouse_pos(&arena, mouse, screen_size.x - 10, 10);
         static size_t animation_ms = 200;
-        draw_animation_ms(&arena, animation_ms, 10, 40);
-        draw_active_layer(&arena, &layers, 10, 70);
-        draw_comparison_layer(&arena, &layers, 10, 100);
 
+        expand_shown_layers(&layers);
         Points *active_points = &layers.elems[layers.active_layer];
 
         // Update
+        profile_begin(PROFILE_INPUT);
         // Usage: Left click to add a point.
         if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
             add_point(active_points, mouse);
@@ -421,6 +644,9 @@ int main() {
         } else if (IsKeyPressed(KEY_LEFT)) {
             switch_to_previous_layer(&layers);
         }
+        // Compact layers are expanded as soon as they are shown, before the keys below edit them or they are drawn.
+        // None of those keys show a hidden layer, Q only compacts layers that are not shown.
+        expand_shown_layers(&layers);
 
         // Usage: space to mark a layer as comparison layer.
         // Pressing space on the active comparison layer disables it.
@@ -455,18 +681,145 @@ int main() {
             animation_time = 1.0;
         }
 
+        // Usage: P to toggle the profiler overlay.
+        if (IsKeyPressed(KEY_P)) show_profiler = !show_profiler;
+
+        // Usage: M to toggle the overlay with the memory stats of the frame arena.
+        if (IsKeyPressed(KEY_M)) show_arena_stats = !show_arena_stats;
+
+        // Usage: O to add a copy of the active layer that is optimized for the vertex cache.
+        if (IsKeyPressed(KEY_O)) optimize_active_layer(&arena, &layers);
+
+        // Usage: Q to compact all layers that are not shown.
+        if (IsKeyPressed(KEY_Q)) compact_hidden_layers(&layers);
+
+        // Usage: S to toggle drawing all visible layers as a single stitched strip.
+        // Usage: Ctrl+S to save the session, if one was specified.
+        bool control = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+        if (IsKeyPressed(KEY_S) && !control) stitching = !stitching;
+        if (IsKeyPressed(KEY_S) && control && session_path != NULL && session_save(&layers, session_path)) {
+            noh_log(NOH_INFO, "Saved %zu layers to %s.", layers.count, session_path);
+        }
+        profile_end(PROFILE_INPUT);
+
+        // Schedule
+        Redraw_State state = {0};
+        state.screen_size = screen_size;
+        state.mouse = mouse;
+        state.layer_count = layers.count;
+        state.active_layer = layers.active_layer;
+        state.comparison_layer = layers.comparison_layer;
+        state.active_version = (ACTIVE)->version;
+        state.comparison_version = HAS_COMPARISON ? (COMPARE)->version : 0;
+        state.moving_index = moving_index;
+        state.animation_ms = animation_ms;
+        state.animating = animation_time > 0.0;
+        state.stitching = stitching;
+
+        // Animations and the overlays need every frame, otherwise block until there is input.
+        bool continuous = state.animating || show_profiler || show_arena_stats;
+        if (continuous && event_waiting) {
+            DisableEventWaiting();
+            event_waiting = false;
+        } else if (!continuous && !event_waiting) {
+            EnableEventWaiting();
+            event_waiting = true;
+        }
+
+        if (scene.texture.width != (int)screen_size.x || scene.texture.height != (int)screen_size.y) {
+            if (scene.id != 0) UnloadRenderTexture(scene);
+            scene = LoadRenderTexture(screen_size.x, screen_size.y);
+            drawn_state.screen_size = CLITERAL(Vector2) { 0 };
+        }
+
         // Draw
-        if (!draw_animation(&arena, screen_center, &animation_time, ACTIVE, COMPARE, animation_ms)) {
-            if (HAS_COMPARISON) draw_layer(&arena, screen_center, moving_index, COMPARE, true);
-            draw_layer(&arena, screen_center, moving_index, ACTIVE, false);
-            if (HAS_COMPARISON) draw_connections(screen_center, ACTIVE, COMPARE);
+        if (state.animating || !redraw_state_eq(&state, &drawn_state)) {
+            BeginTextureMode(scene);
+            ClearBackground(BACKGROUND_COLOR);
+
+            // Hud
+            profile_zone(PROFILE_GRID) draw_grid_and_axes(screen_center);
+            draw_mouse_pos(&arena, mouse, screen_size.x - 10, 10);
+            draw_animation_ms(&arena, animation_ms, 10, 40);
+            update_layer_acmr(&arena, &acmr, &layers);
+            draw_active_layer(&arena, &layers, &acmr, 10, 70);
+            draw_comparison_layer(&arena, &layers, 10, 100);
+
+            bool animated = false;
+            profile_zone(PROFILE_ANIMATION) {
+                animated = draw_animation(&arena, &labels, screen_center, &animation_time, ACTIVE, COMPARE, animation_ms);
+            }
+            if (!animated && !stitching) profile_zone(PROFILE_LAYERS) {
+                if (HAS_COMPARISON) draw_layer(&arena, &labels, screen_center, moving_index, COMPARE, true);
+                draw_layer(&arena, &labels, screen_center, moving_index, ACTIVE, false);
+                if (HAS_COMPARISON) draw_connections(screen_center, ACTIVE, COMPARE);
+            }
+
+            // Stitched, the visible layers are drawn in one strip, which takes one draw call unless it is too large for
+            // the batch. Otherwise every visible layer takes a draw call for its mesh.
+            if (!animated && stitching) profile_zone(PROFILE_LAYERS) {
+                // The strip is built in the arena every frame. Nothing else is allocated while it is built, so it grows
+                // in place.
+                Noh_Arena_Mark mark = noh_arena_mark(&arena);
+                Stitched_Strip stitched = { .allocator = noh_arena_allocator(&arena) };
+                size_t visible_layers = 1;
+                if (HAS_COMPARISON) {
+                    stitch_visible_layer(&stitched, screen_center, COMPARE, true);
+                    visible_layers++;
+                }
+                stitch_visible_layer(&stitched, screen_center, ACTIVE, false);
+                // The flushes are the draw calls before the last one, which is only made if there is a triangle.
+                size_t draw_calls = draw_stitched_strip(&stitched);
+                if (stitched.count >= 3) draw_calls++;
+                draw_draw_calls_saved(&arena, visible_layers > draw_calls ? visible_layers - draw_calls : 0, 10, 130);
+
+                if (HAS_COMPARISON) draw_layer_overlay(&arena, &labels, screen_center, moving_index, COMPARE, true);
+                draw_layer_overlay(&arena, &labels, screen_center, moving_index, ACTIVE, false);
+                if (HAS_COMPARISON) draw_connections(screen_center, ACTIVE, COMPARE);
+                noh_arena_rewind_to(&arena, mark);
+            }
+
+            // Draw which point the mouse is hovering over.
+            DrawCircleV(grid_to_screen(screen_center, mouse), 3, POINT_MOUSE_COLOR);
+
+            EndTextureMode();
+            drawn_state = state;
         }
 
-        // Draw which point the mouse is hovering over.
-        DrawCircleV(grid_to_screen(screen_center, mouse), 3, POINT_MOUSE_COLOR);
+        BeginDrawing();
+        // Render textures are stored upside down.
+        Rectangle source = { 0, 0, scene.texture.width, -scene.texture.height };
+        DrawTextureRec(scene.texture, source, CLITERAL(Vector2) { 0, 0 }, WHITE);
+        if (show_profiler) {
+            Rectangle bounds = { screen_size.x - 370, screen_size.y - 170, 360, 160 };
+            profiler_draw_overlay(&arena, bounds);
+        }
+        if (show_arena_stats) {
+            Rectangle bounds = { 10, screen_size.y - 90, 280, 80 };
+            profiler_draw_arena_overlay(&arena, bounds);
+        }
+        DrawFPS(10, 10);
+        profile_zone(PROFILE_END_DRAWING) EndDrawing();
+        profiler_frame_end();
+        noh_trace_end("frame");
+    }
 
-        EndDrawing();
+    if (session_path != NULL && session_save(&layers, session_path)) {
+        noh_log(NOH_INFO, "Saved %zu layers to %s.", layers.count, session_path);
     }
 
+    for (size_t i = 0; i < layers.count; i++) layer_mesh_unload(&layers.elems[i].mesh);
+    layers_free(&layers);
+    session_unmap(&session);
+    noh_arena_free(&arena);
+    layer_mesh_deinit();
+    label_cache_unload(&labels);
+    profiler_free();
+    UnloadRenderTexture(scene);
     CloseWindow();
+
+    if (trace_path != NULL) {
+        noh_trace_write(trace_path);
+        noh_trace_free();
+    }
 }
@@ -0,0 +1,113 @@
+#include "mesh.h"
+#include <raymath.h>
+#include <rlgl.h>
+
+static const char *mesh_vs_code =
+    "#version 330\n"
+    "in vec2 vertexPosition;\n"
+    "in vec4 vertexColor;\n"
+    "uniform mat4 mvp;\n"
+    "uniform vec2 center;\n"
+    "uniform vec4 tint;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = vertexColor * tint;\n"
+    "    gl_Position = mvp * vec4(center + vertexPosition, 0.0, 1.0);\n"
+    "}\n";
+
+static const char *mesh_fs_code =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+
+static struct {
+    unsigned int shader;
+    int mvp_loc;
+    int center_loc;
+    int tint_loc;
+} mesh_state = {0};
+
+void layer_mesh_init() {
+    mesh_state.shader = rlLoadShaderCode(mesh_vs_code, mesh_fs_code);
+    noh_assert(mesh_state.shader != 0 && "Could not load the layer mesh shader.");
+    mesh_state.mvp_loc = rlGetLocationUniform(mesh_state.shader, "mvp");
+    mesh_state.center_loc = rlGetLocationUniform(mesh_state.shader, "center");
+    mesh_state.tint_loc = rlGetLocationUniform(mesh_state.shader, "tint");
+}
+
+void layer_mesh_deinit() {
+    rlUnloadShaderProgram(mesh_state.shader);
+    mesh_state.shader = 0;
+}
+
+bool layer_mesh_is_stale(Layer_Mesh *mesh, size_t version) {
+    return !mesh->loaded || mesh->version != version;
+}
+
+///////////////////////// Building /////////////////////////
+
+void layer_mesh_update(Noh_Arena *arena, Layer_Mesh *mesh, Vector2 *points, size_t count, size_t version,
+    float spacing, Layer_Colors colors) {
+    size_t vertex_count = layer_geometry_vertex_count(count);
+
+    Noh_Arena_Mark mark = noh_arena_mark(arena);
+    Geometry_Vertex *vertices = noh_arena_push(arena, Geometry_Vertex, vertex_count);
+    Geometry_Vertex *end = layer_geometry_build(vertices, points, count, spacing, CLITERAL(Vector2) { 0 }, colors);
+    noh_assert((size_t)(end - vertices) == vertex_count);
+
+    // Upload, reusing the existing buffer if it is large enough. The buffer grows by doubling, so adding points one by
+    // one does not reallocate it every time.
+    if (mesh->vao == 0) mesh->vao = rlLoadVertexArray();
+    rlEnableVertexArray(mesh->vao);
+    if (vertex_count > mesh->vertex_capacity || mesh->vbo == 0) {
+        if (mesh->vbo != 0) rlUnloadVertexBuffer(mesh->vbo);
+        mesh->vertex_capacity = max(vertex_count * 2, (size_t)1024);
+        mesh->vbo = rlLoadVertexBuffer(NULL, mesh->vertex_capacity * sizeof(Geometry_Vertex), true);
+        rlSetVertexAttribute(0, 2, RL_FLOAT, false, sizeof(Geometry_Vertex), (void *)offsetof(Geometry_Vertex, position));
+        rlEnableVertexAttribute(0);
+        rlSetVertexAttribute(3, 4, RL_UNSIGNED_BYTE, true, sizeof(Geometry_Vertex), (void *)offsetof(Geometry_Vertex, color));
+        rlEnableVertexAttribute(3);
+    }
+    rlUpdateVertexBuffer(mesh->vbo, vertices, vertex_count * sizeof(Geometry_Vertex), 0);
+    rlDisableVertexArray();
+    noh_arena_rewind_to(arena, mark);
+
+    mesh->vertex_count = vertex_count;
+    mesh->version = version;
+    mesh->loaded = true;
+}
+
+///////////////////////// Drawing /////////////////////////
+
+void layer_mesh_draw(Layer_Mesh *mesh, Vector2 center, Color tint) {
+    if (!mesh->loaded || mesh->vertex_count == 0) return;
+
+    // Anything drawn through the batch so far should end up below the mesh.
+    rlDrawRenderBatchActive();
+
+    Matrix mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    float tint_values[4] = { tint.r / 255.0, tint.g / 255.0, tint.b / 255.0, tint.a / 255.0 };
+
+    rlEnableShader(mesh_state.shader);
+    rlSetUniformMatrix(mesh_state.mvp_loc, mvp);
+    rlSetUniform(mesh_state.center_loc, &center, RL_SHADER_UNIFORM_VEC2, 1);
+    rlSetUniform(mesh_state.tint_loc, tint_values, RL_SHADER_UNIFORM_VEC4, 1);
+
+    rlEnableVertexArray(mesh->vao);
+    rlDrawVertexArray(0, mesh->vertex_count);
+    rlDisableVertexArray();
+    rlDisableShader();
+}
+
+void layer_mesh_unload(Layer_Mesh *mesh) {
+    if (mesh->vbo != 0) rlUnloadVertexBuffer(mesh->vbo);
+    if (mesh->vao != 0) rlUnloadVertexArray(mesh->vao);
+    mesh->vao = 0;
+    mesh->vbo = 0;
+    mesh->vertex_count = 0;
+    mesh->vertex_capacity = 0;
+    mesh->loaded = false;
+}
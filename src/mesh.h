@@ -0,0 +1,41 @@
+#ifndef MESH_H_
+#define MESH_H_
+
+#include <raylib.h>
+#include "noh.h"
+#include "geometry.h"
+
+// A retained GPU vertex buffer holding the geometry of a layer. It is only rebuilt when the layer changes.
+// Vertices are stored in pixels relative to the screen center, so drawing only needs the center as a uniform.
+
+typedef struct {
+    unsigned int vao;
+    unsigned int vbo;
+    size_t vertex_count;
+    size_t vertex_capacity; // Number of vertices the vbo has room for.
+    size_t version; // The version of the layer the mesh was built from.
+    bool loaded;
+} Layer_Mesh;
+
+// Loads the shader that layer meshes are drawn with. Requires an OpenGL context, so call it after InitWindow.
+void layer_mesh_init();
+
+// Unloads the shader that layer meshes are drawn with.
+void layer_mesh_deinit();
+
+// Indicates whether the mesh needs to be rebuilt for the specified version of a layer.
+bool layer_mesh_is_stale(Layer_Mesh *mesh, size_t version);
+
+// Rebuilds the mesh from the points of a layer, in grid coordinates, and uploads it to the GPU. Comparison layers
+// reuse the same mesh with a darker tint, so the mesh is always built with the full colors.
+// The arena is only used for temporary data.
+void layer_mesh_update(Noh_Arena *arena, Layer_Mesh *mesh, Vector2 *points, size_t count, size_t version,
+    float spacing, Layer_Colors colors);
+
+// Draws the mesh around the specified screen center, with all colors multiplied by the tint.
+void layer_mesh_draw(Layer_Mesh *mesh, Vector2 center, Color tint);
+
+// Frees the GPU buffers of a mesh.
+void layer_mesh_unload(Layer_Mesh *mesh);
+
+#endif // MESH_H_
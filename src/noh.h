@@ -44,6 +44,9 @@
    #include <direct.h>
 #else
     #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
 #endif // _WIN32
 
 
@@ -135,6 +138,9 @@ struct timespec noh_get_time_in(int seconds, long milliseconds);
 // Adds the specified number of seconds and milliseconds to a timespec.
 void noh_time_add(struct timespec *time, int seconds, long milliseconds);
 
+// Returns a monotonic timestamp in nanoseconds. Only meaningful for measuring durations, not as an absolute time.
+uint64 noh_time_ns();
+
 ///////////////////////// Logging /////////////////////////
 
 // An assert macro that outputs a better format for use with vim's make command.
@@ -155,6 +161,36 @@ typedef enum {
 // Writes a formatted log message to stderr with the provided log level.
 void noh_log(Noh_Log_Level level, const char *fmt, ...);
 
+///////////////////////// Tracing /////////////////////////
+
+#define NOH_TRACE_NAME_CAP 64
+
+// A single trace event, marking the begin or end of a named span on a thread.
+typedef struct {
+    char name[NOH_TRACE_NAME_CAP];
+    uint64 ts_ns;
+    uint64 tid;
+    char phase; // 'B' for begin, 'E' for end.
+} Noh_Trace_Event;
+
+// Starts recording trace events into a preallocated buffer that holds the specified number of events. Events beyond
+// that are dropped. Until this is called, recording an event does nothing.
+void noh_trace_init(size_t capacity);
+
+// Records the start of a span on the current thread. Names longer than NOH_TRACE_NAME_CAP are truncated.
+// Safe to call from multiple threads.
+void noh_trace_begin(const char *name);
+
+// Records the end of a span on the current thread. Safe to call from multiple threads.
+void noh_trace_end(const char *name);
+
+// Writes all recorded events to a file in the Chrome trace event format, which can be opened in chrome://tracing or
+// Perfetto. Should only be called when no other threads are recording events.
+bool noh_trace_write(const char *path);
+
+// Frees the event buffer and stops recording.
+void noh_trace_free();
+
 ///////////////////////// Dynamic array /////////////////////////
 
 #define NOH_DA_INIT_CAP 256
@@ -215,6 +251,65 @@ do {                    \
     (da)->count = 0;    \
 } while (0)
 
+///////////////////////// Allocators /////////////////////////
+
+// Resizes memory from old_size to new_size bytes, keeping the contents up to the smaller of both. The data is NULL if
+// old_size is 0, and is freed if new_size is 0, returning NULL.
+typedef void *(*Noh_Resize)(void *context, void *data, size_t old_size, size_t new_size);
+
+// Where the elements of a dynamic array are allocated, for the noh_da_*_with operations. A zero allocator uses the
+// heap, like the operations without an allocator.
+typedef struct {
+    Noh_Resize resize;
+    void *context;
+    size_t max_size; // The largest size the allocator can provide, or 0 if there is no limit.
+} Noh_Allocator;
+
+// Returns an allocator that uses the heap.
+Noh_Allocator noh_heap_allocator();
+
+// Resizes memory with an allocator, see Noh_Resize.
+void *noh_allocator_resize(Noh_Allocator allocator, void *data, size_t old_size, size_t new_size);
+
+// Grows the elements of a dynamic array to hold at least the required number of elements, doubling the capacity like
+// noh_da_append. Returns the new elements and updates the capacity.
+void *noh_da_grow(Noh_Allocator allocator, void *elems, size_t *capacity, size_t elem_size, size_t required);
+
+// Appends an element to a dynamic array, growing it with the specified allocator if needed.
+#define noh_da_append_with(allocator, da, elem)                                                    \
+do {                                                                                               \
+    if ((da)->count >= (da)->capacity) {                                                           \
+        (da)->elems = noh_da_grow((allocator), (da)->elems, &(da)->capacity, sizeof(*(da)->elems), \
+            (da)->count + 1);                                                                      \
+    }                                                                                              \
+                                                                                                   \
+    (da)->elems[(da)->count++] = (elem);                                                           \
+} while(0)
+
+// Appends multiple elements to a dynamic array, growing it with the specified allocator if needed.
+#define noh_da_append_multiple_with(allocator, da, new_elems, new_elems_count)                     \
+do {                                                                                               \
+    if ((da)->count + (new_elems_count) > (da)->capacity) {                                        \
+        (da)->elems = noh_da_grow((allocator), (da)->elems, &(da)->capacity, sizeof(*(da)->elems), \
+            (da)->count + (new_elems_count));                                                      \
+    }                                                                                              \
+                                                                                                   \
+    memcpy((da)->elems + (da)->count, new_elems, (new_elems_count) * sizeof(*(da)->elems));        \
+    (da)->count += (new_elems_count);                                                              \
+} while (0)
+
+// Frees the elements of a dynamic array with the allocator they were allocated with, and resets the count and
+// capacity.
+#define noh_da_free_with(allocator, da)                                                           \
+do {                                                                                              \
+    if ((da)->capacity > 0) {                                                                     \
+        noh_allocator_resize((allocator), (da)->elems, (da)->capacity * sizeof(*(da)->elems), 0); \
+        (da)->elems = NULL;                                                                       \
+        (da)->count = 0;                                                                          \
+        (da)->capacity = 0;                                                                       \
+    }                                                                                             \
+} while (0)
+
 ///////////////////////// Circular buffer /////////////////////////  
 
 // Initializes a circular buffer, similar to a dynamic array, but adding elements should be done with noh_cb_insert.
@@ -229,6 +324,17 @@ do {                    \
     (da)->count = 0;                                                                                \
 }                                                                                                   \
 
+// Initializes a circular buffer like noh_cb_initialize, allocating the data with the specified allocator.
+#define noh_cb_initialize_with(allocator, da, size) {                                                       \
+    noh_assert((da)->capacity == 0 && "Cannot initialize an already initialized circular buffer.");         \
+    noh_assert((size) > 0 && "Cannot initialize an empty circular buffer.");                                \
+                                                                                                            \
+    (da)->capacity = size;                                                                                  \
+    (da)->elems = noh_allocator_resize((allocator), NULL, 0, (da)->capacity * sizeof(*(da)->elems));        \
+    (da)->start = 0;                                                                                        \
+    (da)->count = 0;                                                                                        \
+}                                                                                                           \
+
 // Inserts an element in a dynamic array as if it is a circular buffer, will not extend beyond the capacity of the
 // dynamic array but instead overwrite the oldest element.
 #define noh_cb_insert(da, elem)                                              \
@@ -272,20 +378,66 @@ typedef struct {
     size_t capacity;
 } Noh_Arena_Data_Blocks;
 
+// The amount of memory that a virtual memory arena commits at a time.
+#define NOH_ARENA_COMMIT_SIZE (64 KB)
+
+// Counters of how an arena is used, to size it and to find churn. They are only counted when NOH_ARENA_STATS is defined
+// for the implementation, the current values in noh_arena_stats are always filled in.
+typedef struct {
+    size_t size; // The bytes that are currently allocated.
+    size_t capacity; // The bytes in all blocks, or committed by a virtual memory arena.
+    size_t peak_size; // The most bytes that were allocated at once.
+    size_t allocated; // The bytes allocated since the arena was initialized.
+    size_t allocations;
+    size_t frame_allocated; // The bytes allocated since the last call to noh_arena_stats_frame.
+    size_t frame_allocations;
+    size_t blocks_created; // The blocks allocated, or the commits of a virtual memory arena.
+    size_t blocks_freed; // The empty blocks that were freed to make room for a larger one.
+    size_t checkpoint_depth; // The checkpoints that are currently saved.
+    size_t peak_checkpoint_depth;
+} Noh_Arena_Stats;
+
+// What happens to blocks of an arena that are empty after a rewind, and too small for the next allocation.
+typedef enum {
+    NOH_ARENA_FREE_EMPTY, // They are freed, so the arena shrinks again after a frame that needed more memory.
+    NOH_ARENA_KEEP_BYTES, // They are kept while all blocks together fit in retain_bytes, freeing the smallest first.
+    NOH_ARENA_MERGE_ON_RESET, // They are kept, and noh_arena_reset merges all blocks into one as large as all of them.
+} Noh_Arena_Retention;
+
 // An arena for storing temporary data.
+// A virtual memory arena has a single range of addresses instead of blocks. Only the part of the range that has been
+// allocated is backed by memory, so allocating is just moving the end of the allocated data.
 typedef struct {
     Noh_Arena_Data_Blocks blocks; // Blocks are always in order of increasing capacity.
     Noh_Arena_Checkpoints checkpoints;
     size_t active_block; // The index of the block up to which data has been allocated.
+    Noh_Arena_Retention retention; // Ignored by virtual memory arenas, which never free memory.
+    size_t retain_bytes;
+
+    char *base; // The start of the range of a virtual memory arena, NULL for an arena of blocks.
+    size_t reserved; // The size of the range.
+    size_t committed; // The size of the part of the range that is backed by memory.
+    size_t size; // The size of the part of the range that is allocated.
+
+    Noh_Arena_Stats stats;
 } Noh_Arena;
 
 // Initialize an empty arena with the specified capacity. A checkpoint is also saved at the empty arena.
 Noh_Arena noh_arena_init(size_t capacity);
 
+// Initialize an empty virtual memory arena, which can hold up to the specified size. The size only reserves addresses,
+// memory is committed in steps of NOH_ARENA_COMMIT_SIZE as it is allocated. A checkpoint is also saved at the empty
+// arena. Where virtual memory is not available, this is an arena of blocks.
+Noh_Arena noh_arena_init_virtual(size_t reserve);
+
 // Resets the size of an arena to 0, keeping the data reserved. Any checkpoints are removed and one is saved at the
 // start of the arena. Requires that the arena is initialized with noh_arena_init.
 void noh_arena_reset(Noh_Arena *arena);
 
+// Sets what happens to empty blocks of an arena, by default they are freed. The number of bytes to keep is only used
+// by NOH_ARENA_KEEP_BYTES.
+void noh_arena_retain(Noh_Arena *arena, Noh_Arena_Retention retention, size_t retain_bytes);
+
 // Frees all data in an arena. Any checkpoints are removed. The arena is no longer initialized, and cannot be used
 // anymore.
 void noh_arena_free(Noh_Arena *arena);
@@ -299,6 +451,17 @@ void noh_arena_reserve(Noh_Arena *arena, size_t size);
 // Requires at least one checkpoint, either from noh_arena_init, noh_arena_reset or noh_arena_save.
 void *noh_arena_alloc(Noh_Arena *arena, size_t size);
 
+// Allocates data in an arena of the requested size, with the start aligned to the specified power of two.
+// Requires at least one checkpoint, either from noh_arena_init, noh_arena_reset or noh_arena_save.
+void *noh_arena_alloc_aligned(Noh_Arena *arena, size_t size, size_t align);
+
+// The alignment of arrays pushed to an arena, a cache line, which is enough for aligned loads of any SIMD register.
+#define NOH_ARENA_PUSH_ALIGN ((size_t)64)
+
+// Allocates an array of count elements of the specified type in an arena, aligned to NOH_ARENA_PUSH_ALIGN.
+#define noh_arena_push(arena, type, count) \
+    ((type *)noh_arena_alloc_aligned((arena), sizeof(type) * (count), max(_Alignof(type), NOH_ARENA_PUSH_ALIGN)))
+
 // Saves the current position in of the arena in a checkpoint. Requires that the arena is initialized with
 // noh_arena_init.
 void noh_arena_save(Noh_Arena *arena);
@@ -306,12 +469,121 @@ void noh_arena_save(Noh_Arena *arena);
 // Rewinds an arena to the last saved checkpoint. Requires at least one checkpoint.
 void noh_arena_rewind(Noh_Arena *arena);
 
+// A position in an arena, kept by the caller instead of on the checkpoint stack of the arena.
+typedef Noh_Arena_Checkpoint Noh_Arena_Mark;
+
+// Returns the current position in an arena. Requires that the arena is initialized.
+Noh_Arena_Mark noh_arena_mark(Noh_Arena *arena);
+
+// Rewinds an arena to a position returned by noh_arena_mark. Any marks taken after it can no longer be used.
+void noh_arena_rewind_to(Noh_Arena *arena, Noh_Arena_Mark mark);
+
+typedef struct {
+    Noh_Arena_Mark mark;
+    bool done;
+} Noh_Arena_Temp_;
+
+// Rewinds the arena after the statement or block that follows it, so everything allocated in it is temporary.
+// Leaving the block with return, break or goto skips the rewind, use noh_arena_mark in that case.
+// Usage:
+//   noh_arena_temp(arena) draw_text(noh_arena_sprintf(arena, "%d", n), x, y);
+#define noh_arena_temp(arena)                                                                        \
+    for (Noh_Arena_Temp_ noh_arena_temp_ = { noh_arena_mark(arena), false }; !noh_arena_temp_.done; \
+        noh_arena_rewind_to((arena), noh_arena_temp_.mark), noh_arena_temp_.done = true)
+
+// Returns an allocator for dynamic arrays in an arena. An array that was the last allocation in the arena grows in
+// place, otherwise it is copied to the top of the arena. Freeing only gives back memory if the array is still on top.
+Noh_Allocator noh_arena_allocator(Noh_Arena *arena);
+
+// Returns the stats of an arena, with its current size, capacity and checkpoint depth.
+Noh_Arena_Stats noh_arena_stats(Noh_Arena *arena);
+
+// Starts a new frame in the stats of an arena, so the bytes allocated per frame are counted from here.
+void noh_arena_stats_frame(Noh_Arena *arena);
+
 // Copies a c-string to the arena.
 char *noh_arena_strdup(Noh_Arena *arena, const char *cstr);
 
 // Prints the specified formatted string to the arena.
 char *noh_arena_sprintf(Noh_Arena *arena, const char *format, ...);
 
+///////////////////////// Scratch arenas /////////////////////////
+
+// Every thread has its own scratch arenas for temporary data, so any thread can allocate without locks or malloc.
+// There are two, so a function that allocates its result in an arena of its caller can always get a scratch arena
+// that is not that arena.
+
+#define NOH_SCRATCH_COUNT 2
+
+// The addresses reserved for each scratch arena, which are only backed by memory once they are allocated.
+#define NOH_SCRATCH_RESERVE ((size_t)1 GB)
+
+// A scratch arena in use, with the position it is rewound to when it is released.
+typedef struct {
+    Noh_Arena *arena;
+    Noh_Arena_Mark mark;
+} Noh_Scratch;
+
+// Returns a scratch arena of the calling thread that is none of the conflicting arenas, which should be the arenas
+// that anything being allocated in during the scratch is in. The scratch arenas are initialized on first use.
+// Usage:
+//   Noh_Scratch scratch = noh_scratch_begin(&result_arena, 1);
+//   uint *temp = noh_arena_push(scratch.arena, uint, count);
+//   noh_scratch_end(scratch);
+Noh_Scratch noh_scratch_begin(Noh_Arena **conflicts, size_t conflict_count);
+
+// Releases a scratch arena, freeing everything allocated in it since noh_scratch_begin.
+void noh_scratch_end(Noh_Scratch scratch);
+
+// Frees the scratch arenas of the calling thread. Threads that used scratch arenas should call this before exiting.
+void noh_scratch_free();
+
+///////////////////////// Pool /////////////////////////
+
+// A pool allocates objects of a single size from slabs, which are never freed until the pool is. Freed objects are
+// kept in a list that runs through the objects themselves, so allocating and freeing an object are O(1) and need no
+// memory of their own.
+
+// The size of the slabs, a page.
+#define NOH_POOL_SLAB_SIZE (4 KB)
+
+typedef struct Noh_Pool_Object {
+    struct Noh_Pool_Object *next;
+} Noh_Pool_Object;
+
+typedef struct {
+    char **elems;
+    size_t count;
+    size_t capacity;
+} Noh_Pool_Slabs;
+
+typedef struct {
+    size_t object_size; // The requested size, rounded up to hold a pointer and to a multiple of 8.
+    size_t slab_objects; // The number of objects in a slab.
+    Noh_Pool_Slabs slabs;
+    size_t active_slab; // The slab that unused objects are taken from.
+    size_t slab_used; // The number of objects taken from the active slab.
+    Noh_Pool_Object *free_list; // Objects that were freed, which are used before any unused objects.
+} Noh_Pool;
+
+// Initializes an empty pool for objects of the specified size. No slab is allocated until the first object is.
+Noh_Pool noh_pool_init(size_t object_size);
+
+// Allocates an object from a pool. Its contents are undefined.
+void *noh_pool_alloc(Noh_Pool *pool);
+
+// Returns an object to the pool it was allocated from.
+void noh_pool_release(Noh_Pool *pool, void *object);
+
+// Frees all objects in a pool at once, keeping the slabs to allocate from again.
+void noh_pool_reset(Noh_Pool *pool);
+
+// Frees all slabs of a pool. The pool can be used again, as if it was just initialized.
+void noh_pool_free(Noh_Pool *pool);
+
+// Returns an allocator for dynamic arrays in objects of a pool, which can hold as many elements as fit in one object.
+Noh_Allocator noh_pool_allocator(Noh_Pool *pool);
+
 ///////////////////////// Strings /////////////////////////  
 
 // Defines a string that can be extended.
@@ -333,7 +605,8 @@ void noh_string_append_null(Noh_String *string);
 // Resets a Noh_String, setting the count to 0.
 #define noh_string_reset(string) noh_da_reset(string)
 
-// Reads the contents of a file into a Noh_String.
+// Reads the contents of a file into a Noh_String. The string is grown to the size of the file first, so the file is
+// read with a single read.
 bool noh_string_read_file(Noh_String *string, const char *filename);
 
 ///////////////////////// String view /////////////////////////  
@@ -348,6 +621,10 @@ typedef struct {
 // that delimiter. The string view itself is shrunk to start after the delimiter.
 Noh_String_View noh_sv_chop_by_delim(Noh_String_View *sv, char delim);
 
+// Skips any whitespace at the start of a string view and returns the part of the string until the next whitespace.
+// The string view itself is shrunk to start after that part.
+Noh_String_View noh_sv_chop_by_space(Noh_String_View *sv);
+
 // Trims the left part of a string view, until the provided function no longer holds on the current character.
 void noh_sv_trim_left(Noh_String_View *sv, bool (*do_trim)(char));
 
@@ -393,7 +670,7 @@ const char *noh_sv_to_arena_cstr(Noh_Arena *arena, Noh_String_View sv);
 
 // printf macros for Noh_String_View
 #define Nsv_Fmt "%.*s"
-#define Nsv_Arg(sv) (int) (sv).count, (sv).data
+#define Nsv_Arg(sv) (int) (sv).count, (sv).elems
 // USAGE:
 //   Noh_String_View name = ...;
 //   printf("Name: "Nsv_Fmt"\n", Nsv_Arg(name));
@@ -417,6 +694,20 @@ bool noh_rename(const char *path, const char *new_path);
 // Removes a file.
 bool noh_remove(const char *path);
 
+// A read-only view of the contents of a file.
+typedef struct {
+    Noh_String_View contents;
+    bool mapped; // Whether the contents are mapped into memory, otherwise they are read into an allocated buffer.
+} Noh_File_Map;
+
+// Maps a file into memory, without copying it, and hints that it will be read sequentially. If the file can't be
+// mapped, it is read into a buffer of its size with a single read instead. The contents stay valid until the file is
+// unmapped, even if the file is replaced in the meantime.
+bool noh_file_map(Noh_File_Map *map, const char *path);
+
+// Unmaps a file, or frees the buffer it was read into.
+void noh_file_unmap(Noh_File_Map *map);
+
 #endif // NOH_H_
 
 #ifdef NOH_IMPLEMENTATION
@@ -478,6 +769,17 @@ void noh_time_add(struct timespec *time, int seconds, long milliseconds) {
     }
 }
 
+uint64 noh_time_ns() {
+    struct timespec time;
+    if (clock_gettime(CLOCK_MONOTONIC, &time) == -1)
+    {
+        noh_log(NOH_ERROR, "Unable to get the monotonic time: %s", strerror(errno));
+        exit(1);
+    }
+
+    return (uint64)time.tv_sec * 1000 * 1000 * 1000 + (uint64)time.tv_nsec;
+}
+
 ///////////////////////// Logging /////////////////////////  
 
 void noh_log(Noh_Log_Level level, const char *fmt, ...)
@@ -503,11 +805,138 @@ void noh_log(Noh_Log_Level level, const char *fmt, ...)
     fprintf(stderr, "\n");
 }
 
+///////////////////////// Tracing /////////////////////////
+
+static struct {
+    Noh_Trace_Event *events;
+    size_t capacity;
+    size_t count; // Claimed slots, may exceed capacity when events were dropped.
+    uint64 start_ns;
+    uint64 next_tid;
+} noh_trace = {0};
+
+// Small sequential thread ids, assigned on the first event of a thread.
+static _Thread_local uint64 noh_trace_tid = 0;
+
+void noh_trace_init(size_t capacity) {
+    noh_assert(noh_trace.events == NULL && "Tracing is already initialized.");
+    noh_trace.events = noh_realloc_check(NULL, capacity * sizeof(Noh_Trace_Event));
+    noh_trace.capacity = capacity;
+    noh_trace.count = 0;
+    noh_trace.start_ns = noh_time_ns();
+}
+
+// Records an event in the next free slot of the buffer.
+static void noh_trace_record(const char *name, char phase) {
+    if (noh_trace.events == NULL) return;
+
+    uint64 now = noh_time_ns();
+    if (noh_trace_tid == 0) noh_trace_tid = __atomic_add_fetch(&noh_trace.next_tid, 1, __ATOMIC_RELAXED);
+
+    size_t i = __atomic_fetch_add(&noh_trace.count, 1, __ATOMIC_RELAXED);
+    if (i >= noh_trace.capacity) return;
+
+    Noh_Trace_Event *event = &noh_trace.events[i];
+    strncpy(event->name, name, NOH_TRACE_NAME_CAP - 1);
+    event->name[NOH_TRACE_NAME_CAP - 1] = '\0';
+    event->ts_ns = now;
+    event->tid = noh_trace_tid;
+    event->phase = phase;
+}
+
+void noh_trace_begin(const char *name) {
+    noh_trace_record(name, 'B');
+}
+
+void noh_trace_end(const char *name) {
+    noh_trace_record(name, 'E');
+}
+
+bool noh_trace_write(const char *path) {
+    bool result = true;
+    if (noh_trace.events == NULL) return false;
+
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        noh_log(NOH_ERROR, "Could not open file %s: %s.", path, strerror(errno));
+        noh_return_defer(false);
+    }
+
+    size_t count = min(noh_trace.count, noh_trace.capacity);
+    if (noh_trace.count > noh_trace.capacity) {
+        noh_log(NOH_WARNING, "Trace buffer was full, dropped %zu events.", noh_trace.count - noh_trace.capacity);
+    }
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t i = 0; i < count; i++) {
+        Noh_Trace_Event *event = &noh_trace.events[i];
+        fprintf(f, "{\"name\":\"");
+        for (char *c = event->name; *c; c++) {
+            if (*c == '"' || *c == '\\') fputc('\\', f);
+            if ((unsigned char)*c >= 0x20) fputc(*c, f);
+        }
+        uint64 ts_ns = event->ts_ns - noh_trace.start_ns;
+        fprintf(f, "\",\"ph\":\"%c\",\"ts\":%lu.%03lu,\"pid\":1,\"tid\":%lu}%s\n",
+            event->phase, ts_ns / 1000, ts_ns % 1000, event->tid, i + 1 < count ? "," : "");
+    }
+    fprintf(f, "]}\n");
+
+    if (ferror(f)) {
+        noh_log(NOH_ERROR, "Could not write file %s: %s.", path, strerror(errno));
+        noh_return_defer(false);
+    }
+
+    noh_log(NOH_INFO, "Wrote %zu trace events to '%s'.", count, path);
+
+defer:
+    if (f) fclose(f);
+    return result;
+}
+
+void noh_trace_free() {
+    free(noh_trace.events);
+    noh_trace.events = NULL;
+    noh_trace.capacity = 0;
+    noh_trace.count = 0;
+}
+
+///////////////////////// Allocators /////////////////////////
+
+static void *noh_heap_resize(void *context, void *data, size_t old_size, size_t new_size) {
+    (void)context;
+    (void)old_size;
+    if (new_size == 0) {
+        free(data);
+        return NULL;
+    }
+    return noh_realloc_check(data, new_size);
+}
+
+Noh_Allocator noh_heap_allocator() {
+    return (Noh_Allocator) { .resize = noh_heap_resize };
+}
+
+void *noh_allocator_resize(Noh_Allocator allocator, void *data, size_t old_size, size_t new_size) {
+    if (allocator.resize == NULL) return noh_heap_resize(NULL, data, old_size, new_size);
+    return allocator.resize(allocator.context, data, old_size, new_size);
+}
+
+void *noh_da_grow(Noh_Allocator allocator, void *elems, size_t *capacity, size_t elem_size, size_t required) {
+    size_t new_capacity = *capacity == 0 ? NOH_DA_INIT_CAP : *capacity * 2;
+    while (new_capacity < required) new_capacity *= 2;
+    if (allocator.max_size > 0) new_capacity = min(new_capacity, allocator.max_size / elem_size);
+    noh_assert(new_capacity >= required && "The allocator cannot hold this many elements.");
+
+    elems = noh_allocator_resize(allocator, elems, *capacity * elem_size, new_capacity * elem_size);
+    *capacity = new_capacity;
+    return elems;
+}
+
 ///////////////////////// Arena /////////////////////////  
 
-// Alin a size such that it is a multiple of 8, keeping blocks of 64 bits.
+// Align a size such that it is a multiple of 8, keeping blocks of 64 bits.
 size_t align_size(size_t size) {
-    return size + (size % 8);
+    return (size + 7) & ~(size_t)7;
 }
 
 Noh_Arena noh_arena_init(size_t size) {
@@ -532,9 +961,83 @@ Noh_Arena noh_arena_init(size_t size) {
     return arena;
 }
 
+Noh_Arena noh_arena_init_virtual(size_t reserve) {
+#ifdef _WIN32
+    return noh_arena_init(NOH_ARENA_INIT_CAP);
+#else
+    Noh_Arena arena = {0};
+    arena.reserved = (reserve + NOH_ARENA_COMMIT_SIZE - 1) / NOH_ARENA_COMMIT_SIZE * NOH_ARENA_COMMIT_SIZE;
+    arena.base = mmap(NULL, arena.reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    noh_assert(arena.base != MAP_FAILED && "Could not reserve memory for the arena");
+
+    noh_arena_save(&arena);
+    return arena;
+#endif // _WIN32
+}
+
+// Executes a statement that updates the stats of an arena, only if they are counted.
+#ifdef NOH_ARENA_STATS
+#define noh_arena_stat(statement) do { statement; } while (0)
+#else
+#define noh_arena_stat(statement) do {} while (0)
+#endif // NOH_ARENA_STATS
+
+// Returns the number of bytes that are currently allocated in an arena.
+static size_t noh_arena_used(Noh_Arena *arena) {
+    if (arena->base != NULL) return arena->size;
+
+    size_t used = 0;
+    for (size_t i = 0; i <= arena->active_block && i < arena->blocks.count; i++) used += arena->blocks.elems[i].size;
+    return used;
+}
+
+// Returns the total capacity of the blocks of an arena.
+static size_t noh_arena_block_capacity(Noh_Arena *arena) {
+    size_t capacity = 0;
+    for (size_t i = 0; i < arena->blocks.count; i++) capacity += arena->blocks.elems[i].capacity;
+    return capacity;
+}
+
+// The size of an arena only shrinks when it is rewound, so the peak is taken just before that, instead of on every
+// allocation.
+static void noh_arena_stats_peak(Noh_Arena *arena) {
+    (void)arena;
+    noh_arena_stat(arena->stats.peak_size = max(arena->stats.peak_size, noh_arena_used(arena)));
+}
+
+// Commits enough memory in a virtual memory arena to hold the specified size.
+static void noh_arena_commit(Noh_Arena *arena, size_t size) {
+#ifndef _WIN32
+    noh_assert(size <= arena->reserved && "The arena is out of reserved memory");
+    size_t new_committed = (size + NOH_ARENA_COMMIT_SIZE - 1) / NOH_ARENA_COMMIT_SIZE * NOH_ARENA_COMMIT_SIZE;
+    if (new_committed > arena->reserved) new_committed = arena->reserved;
+
+    int result = mprotect(arena->base + arena->committed, new_committed - arena->committed, PROT_READ | PROT_WRITE);
+    noh_assert(result == 0 && "Could not commit memory for the arena");
+    arena->committed = new_committed;
+    noh_arena_stat(arena->stats.blocks_created += 1);
+#else
+    (void)arena;
+    (void)size;
+#endif // _WIN32
+}
+
 void noh_arena_reset(Noh_Arena *arena) {
     // We need to load a block and save it in the checkpoint, so at least one block needs to be allocated.
-    noh_assert(arena->blocks.count > 0 && "Please ensure that the arena is inintialized.");
+    noh_assert((arena->base != NULL || arena->blocks.count > 0) && "Please ensure that the arena is inintialized.");
+
+    noh_arena_stats_peak(arena);
+
+    // Replace the blocks by one that can hold everything they could, so the next frames need a single block.
+    if (arena->retention == NOH_ARENA_MERGE_ON_RESET && arena->blocks.count > 1) {
+        Noh_Arena_Data_Block merged = { .capacity = noh_arena_block_capacity(arena) };
+        for (size_t i = 0; i < arena->blocks.count; i++) free(arena->blocks.elems[i].data);
+        noh_arena_stat(arena->stats.blocks_freed += arena->blocks.count; arena->stats.blocks_created += 1);
+        merged.data = noh_realloc_check(NULL, merged.capacity);
+        noh_da_reset(&arena->blocks);
+        noh_da_append(&arena->blocks, merged);
+        arena->active_block = 0;
+    }
 
     // Reset checkpoints.
     noh_da_reset(&arena->checkpoints);
@@ -550,6 +1053,11 @@ void noh_arena_reset(Noh_Arena *arena) {
     arena->checkpoints.count += 1;
 }
 
+void noh_arena_retain(Noh_Arena *arena, Noh_Arena_Retention retention, size_t retain_bytes) {
+    arena->retention = retention;
+    arena->retain_bytes = retain_bytes;
+}
+
 void noh_arena_free(Noh_Arena *arena) {
     // Remove checkpoints.
     noh_da_free(&arena->checkpoints);
@@ -564,12 +1072,31 @@ void noh_arena_free(Noh_Arena *arena) {
     noh_da_free(&arena->blocks);
 
     arena->active_block = 0;
+
+#ifndef _WIN32
+    if (arena->base != NULL) munmap(arena->base, arena->reserved);
+#endif // _WIN32
+    arena->base = NULL;
+    arena->reserved = 0;
+    arena->committed = 0;
+    arena->size = 0;
+    arena->stats = (Noh_Arena_Stats) {0};
 }
 
 void *noh_arena_alloc(Noh_Arena *arena, size_t size) {
     // This is technically not needed, but it is nice to be consistent and ensure that there is always a checkpoint
     // at the beginning, either from noh_arena_init, noh_arena_reset or noh_arena_save.
     noh_assert(arena->checkpoints.count > 0 && "Please ensure that there is at least one checkpoint before allocating.");
+    noh_arena_stat(arena->stats.allocated += size; arena->stats.frame_allocated += size;
+        arena->stats.allocations += 1; arena->stats.frame_allocations += 1);
+
+    // A virtual memory arena only needs to move the end of the allocated data.
+    if (arena->base != NULL) {
+        if (arena->committed - arena->size < size) noh_arena_commit(arena, arena->size + size);
+        void *result = arena->base + arena->size;
+        arena->size += size;
+        return result;
+    }
 
     // Reserve will ensure that we have the required space available. Then we just need to find the block where we can
     // allocate the requested space.
@@ -593,7 +1120,37 @@ void *noh_arena_alloc(Noh_Arena *arena, size_t size) {
     return result;
 }
 
+void *noh_arena_alloc_aligned(Noh_Arena *arena, size_t size, size_t align) {
+    noh_assert(align > 0 && (align & (align - 1)) == 0 && "Alignment must be a power of two.");
+
+    // Allocate room for the largest possible padding, then give back the part that is not needed, so the next
+    // allocation starts right after the aligned data. The data is always at the end of the active block.
+    char *data = noh_arena_alloc(arena, size + align - 1);
+    size_t padding = (align - (uintptr_t)data % align) % align;
+    size_t unused = align - 1 - padding;
+    if (arena->base != NULL) arena->size -= unused;
+    else arena->blocks.elems[arena->active_block].size -= unused;
+    noh_arena_stat(arena->stats.allocated -= unused; arena->stats.frame_allocated -= unused);
+
+    return data + padding;
+}
+
+// Indicates whether the retention policy of an arena keeps an empty block that is too small.
+static bool noh_arena_keeps_block(Noh_Arena *arena) {
+    switch (arena->retention) {
+        case NOH_ARENA_FREE_EMPTY: return false;
+        case NOH_ARENA_KEEP_BYTES: return noh_arena_block_capacity(arena) <= arena->retain_bytes;
+        case NOH_ARENA_MERGE_ON_RESET: return true;
+    }
+    return false;
+}
+
 void noh_arena_reserve(Noh_Arena *arena, size_t size) {
+    if (arena->base != NULL) {
+        if (arena->committed - arena->size < size) noh_arena_commit(arena, arena->size + size);
+        return;
+    }
+
     noh_assert(arena->blocks.count > 0 && "Please ensure that the arena is initialized.");
 
     size_t requested_size = align_size(size);
@@ -605,10 +1162,12 @@ void noh_arena_reserve(Noh_Arena *arena, size_t size) {
             return;
         }
 
-        // If it doesn't, free the block if it was empty. Note that all but the current block will be empty, since
-        // rewinding sets the sizes of later blocks to 0. Current block may be empty.
-        if (block->size == 0) {
+        // If it doesn't, free the block if it was empty and the retention policy doesn't keep it. Note that all but
+        // the current block will be empty, since rewinding sets the sizes of later blocks to 0. Current block may be
+        // empty. Kept blocks are skipped, and used again after the next rewind.
+        if (block->size == 0 && !noh_arena_keeps_block(arena)) {
             free(block->data);
+            noh_arena_stat(arena->stats.blocks_freed += 1);
 
             // This reduces arena->blocks.count, thus ensuring termination of the loop.
             noh_da_remove_at(&arena->blocks, arena->active_block);
@@ -638,9 +1197,20 @@ void noh_arena_reserve(Noh_Arena *arena, size_t size) {
 
     // After adding this block, arena->active_block will point to this new block.
     noh_da_append(&(arena->blocks), new_block);
+    noh_arena_stat(arena->stats.blocks_created += 1);
 }
 
 void noh_arena_save(Noh_Arena *arena) {
+    noh_arena_stat(arena->stats.peak_checkpoint_depth = max(arena->stats.peak_checkpoint_depth,
+        arena->checkpoints.count + 1));
+
+    // A virtual memory arena has a single block.
+    if (arena->base != NULL) {
+        Noh_Arena_Checkpoint checkpoint = { .block_id = 0, .offset_in_block = arena->size };
+        noh_da_append(&(arena->checkpoints), checkpoint);
+        return;
+    }
+
     // We need to load a block and save it in the checkpoint, so at least one block needs to be allocated.
     noh_assert(arena->blocks.count > 0 && "Please ensure that the arena is inintialized.");
 
@@ -655,10 +1225,12 @@ void noh_arena_save(Noh_Arena *arena) {
 
 void noh_arena_rewind(Noh_Arena *arena) {
     noh_assert(arena->checkpoints.count > 0 && "No history to rewind");
+    noh_arena_stats_peak(arena);
 
     // Restore to block from checkpoint.
     Noh_Arena_Checkpoint *checkpoint = &arena->checkpoints.elems[arena->checkpoints.count - 1];
     arena->active_block = checkpoint->block_id;
+    if (arena->base != NULL) arena->size = checkpoint->offset_in_block;
 
     // Rewind all blocks from the active block to the end.
     for (size_t i = arena->active_block; i < arena->blocks.count; i++) {
@@ -672,6 +1244,85 @@ void noh_arena_rewind(Noh_Arena *arena) {
     arena->checkpoints.count -= 1;
 }
 
+Noh_Arena_Mark noh_arena_mark(Noh_Arena *arena) {
+    if (arena->base != NULL) return (Noh_Arena_Mark) { .block_id = 0, .offset_in_block = arena->size };
+
+    noh_assert(arena->blocks.count > 0 && "Please ensure that the arena is initialized.");
+    Noh_Arena_Mark mark = { .block_id = arena->active_block };
+    mark.offset_in_block = arena->blocks.elems[arena->active_block].size;
+    return mark;
+}
+
+void noh_arena_rewind_to(Noh_Arena *arena, Noh_Arena_Mark mark) {
+    noh_arena_stats_peak(arena);
+    if (arena->base != NULL) {
+        arena->size = mark.offset_in_block;
+        return;
+    }
+
+    // Only the blocks up to the active block can have data in them.
+    for (size_t i = mark.block_id; i <= arena->active_block && i < arena->blocks.count; i++) {
+        arena->blocks.elems[i].size = i == mark.block_id ? mark.offset_in_block : 0;
+    }
+    arena->active_block = mark.block_id;
+}
+
+// Indicates whether data of the specified size ends at the top of an arena.
+static bool noh_arena_is_top(Noh_Arena *arena, char *data, size_t size) {
+    if (data == NULL) return false;
+    if (arena->base != NULL) return data + size == arena->base + arena->size;
+
+    Noh_Arena_Data_Block *block = &arena->blocks.elems[arena->active_block];
+    return data + size == block->data + block->size;
+}
+
+static void *noh_arena_resize(void *context, void *data, size_t old_size, size_t new_size) {
+    Noh_Arena *arena = context;
+    bool top = noh_arena_is_top(arena, data, old_size);
+
+    if (new_size == 0) {
+        if (!top) return NULL;
+        noh_arena_stats_peak(arena);
+        if (arena->base != NULL) arena->size -= old_size;
+        else arena->blocks.elems[arena->active_block].size -= old_size;
+        return NULL;
+    }
+    if (new_size <= old_size) return data;
+
+    // On top of the arena, the array only needs the end of the arena to move, as long as the active block has room.
+    // The room is checked for the aligned size, like noh_arena_reserve does, otherwise the allocation would move on to
+    // the next block while the array is still grown in place.
+    size_t grow = new_size - old_size;
+    if (top && (arena->base != NULL || arena->blocks.elems[arena->active_block].capacity
+        - arena->blocks.elems[arena->active_block].size >= align_size(grow))) {
+        noh_arena_alloc(arena, grow);
+        return data;
+    }
+
+    void *result = noh_arena_alloc_aligned(arena, new_size, NOH_ARENA_PUSH_ALIGN);
+    if (old_size > 0) memcpy(result, data, old_size);
+    return result;
+}
+
+Noh_Allocator noh_arena_allocator(Noh_Arena *arena) {
+    return (Noh_Allocator) { .resize = noh_arena_resize, .context = arena };
+}
+
+Noh_Arena_Stats noh_arena_stats(Noh_Arena *arena) {
+    noh_arena_stats_peak(arena);
+
+    Noh_Arena_Stats stats = arena->stats;
+    stats.size = noh_arena_used(arena);
+    stats.capacity = arena->committed + noh_arena_block_capacity(arena);
+    stats.checkpoint_depth = arena->checkpoints.count;
+    return stats;
+}
+
+void noh_arena_stats_frame(Noh_Arena *arena) {
+    arena->stats.frame_allocated = 0;
+    arena->stats.frame_allocations = 0;
+}
+
 char *noh_arena_strdup(Noh_Arena *arena, const char *cstr) {
     size_t len = strlen(cstr);
     char *result = noh_arena_alloc(arena, len + 1);
@@ -695,6 +1346,104 @@ char *noh_arena_sprintf(Noh_Arena *arena, const char *format, ...) {
     return result;
 }
 
+///////////////////////// Scratch arenas /////////////////////////
+
+static _Thread_local Noh_Arena noh_scratch_arenas[NOH_SCRATCH_COUNT];
+
+Noh_Scratch noh_scratch_begin(Noh_Arena **conflicts, size_t conflict_count) {
+    for (size_t i = 0; i < NOH_SCRATCH_COUNT; i++) {
+        Noh_Arena *arena = &noh_scratch_arenas[i];
+        bool conflicting = false;
+        for (size_t c = 0; c < conflict_count && !conflicting; c++) conflicting = conflicts[c] == arena;
+        if (conflicting) continue;
+
+        if (arena->checkpoints.count == 0) *arena = noh_arena_init_virtual(NOH_SCRATCH_RESERVE);
+        return (Noh_Scratch) { .arena = arena, .mark = noh_arena_mark(arena) };
+    }
+
+    noh_assert(false && "All scratch arenas conflict, pass fewer conflicting arenas.");
+    return (Noh_Scratch) {0};
+}
+
+void noh_scratch_end(Noh_Scratch scratch) {
+    noh_arena_rewind_to(scratch.arena, scratch.mark);
+}
+
+void noh_scratch_free() {
+    for (size_t i = 0; i < NOH_SCRATCH_COUNT; i++) {
+        if (noh_scratch_arenas[i].checkpoints.count == 0) continue;
+        noh_arena_free(&noh_scratch_arenas[i]);
+        noh_scratch_arenas[i] = (Noh_Arena) {0};
+    }
+}
+
+///////////////////////// Pool /////////////////////////
+
+Noh_Pool noh_pool_init(size_t object_size) {
+    Noh_Pool pool = {0};
+    pool.object_size = align_size(max(object_size, sizeof(Noh_Pool_Object)));
+    pool.slab_objects = max(NOH_POOL_SLAB_SIZE / pool.object_size, (size_t)1);
+    return pool;
+}
+
+void *noh_pool_alloc(Noh_Pool *pool) {
+    noh_assert(pool->object_size > 0 && "Please ensure that the pool is initialized.");
+
+    if (pool->free_list != NULL) {
+        Noh_Pool_Object *object = pool->free_list;
+        pool->free_list = object->next;
+        return object;
+    }
+
+    // Take the next unused object, moving on to the next slab when the active one is used up.
+    if (pool->slabs.count == 0 || pool->slab_used == pool->slab_objects) {
+        if (pool->slabs.count > 0) pool->active_slab += 1;
+        if (pool->active_slab == pool->slabs.count) {
+            char *slab = noh_realloc_check(NULL, pool->slab_objects * pool->object_size);
+            noh_da_append(&pool->slabs, slab);
+        }
+        pool->slab_used = 0;
+    }
+
+    return pool->slabs.elems[pool->active_slab] + pool->object_size * pool->slab_used++;
+}
+
+void noh_pool_release(Noh_Pool *pool, void *object) {
+    Noh_Pool_Object *released = object;
+    released->next = pool->free_list;
+    pool->free_list = released;
+}
+
+void noh_pool_reset(Noh_Pool *pool) {
+    pool->free_list = NULL;
+    pool->active_slab = 0;
+    pool->slab_used = 0;
+}
+
+void noh_pool_free(Noh_Pool *pool) {
+    for (size_t i = 0; i < pool->slabs.count; i++) free(pool->slabs.elems[i]);
+    noh_da_free(&pool->slabs);
+    pool->slabs = (Noh_Pool_Slabs) {0};
+    noh_pool_reset(pool);
+}
+
+// Arrays never grow beyond the size of an object, so an array keeps its object until it is freed.
+static void *noh_pool_resize(void *context, void *data, size_t old_size, size_t new_size) {
+    Noh_Pool *pool = context;
+    (void)old_size;
+    if (new_size == 0) {
+        if (data != NULL) noh_pool_release(pool, data);
+        return NULL;
+    }
+
+    noh_assert(new_size <= pool->object_size && "Data does not fit in an object of the pool.");
+    return data != NULL ? data : noh_pool_alloc(pool);
+}
+
+Noh_Allocator noh_pool_allocator(Noh_Pool *pool) {
+    return (Noh_Allocator) { .resize = noh_pool_resize, .context = pool, .max_size = pool->object_size };
+}
+
 ///////////////////////// Strings /////////////////////////
 
 void noh_string_append_cstr(Noh_String *string, const char *cstr) {
@@ -708,29 +1457,42 @@ void noh_string_append_null(Noh_String *string) {
 
 bool noh_string_read_file(Noh_String *string, const char *filename) {
     bool result = true;
-    size_t buf_size = 32*1024;
-    char *buf = NULL;
-    buf = noh_realloc_check(buf, buf_size);
 
     FILE *f = fopen(filename, "rb");
     if (f == NULL) {
-        noh_log(NOH_ERROR, "Could not open file %s: %s.\n", filename, strerror(errno));
+        noh_log(NOH_ERROR, "Could not open file %s: %s.", filename, strerror(errno));
         noh_return_defer(false);
     }
 
-    size_t n = fread(buf, 1, buf_size, f);
-    while (n > 0) {
-        noh_da_append_multiple(string, buf, n);
-        n = fread(buf, 1, buf_size, f);
+    // Files that don't report their size, like pipes, are read in growing chunks.
+    size_t chunk_size = 32*1024;
+#ifndef _WIN32
+    struct stat st;
+    if (fstat(fileno(f), &st) == 0 && st.st_size > 0) chunk_size = (size_t)st.st_size + 1;
+#endif // _WIN32
+
+    // The file is read directly into the string, which grows by at least its current size when it is full.
+    if (string->capacity - string->count < chunk_size) {
+        string->capacity = string->count + chunk_size;
+        string->elems = noh_realloc_check(string->elems, string->capacity);
+    }
+    for (;;) {
+        size_t n = fread(string->elems + string->count, 1, string->capacity - string->count, f);
+        if (n == 0) break;
+        string->count += n;
+
+        if (string->count == string->capacity) {
+            string->capacity += max(chunk_size, string->count);
+            string->elems = noh_realloc_check(string->elems, string->capacity);
+        }
     }
 
     if (ferror(f)) {
-        noh_log(NOH_ERROR, "Could not read file %s: %s.\n", filename, strerror(errno));
+        noh_log(NOH_ERROR, "Could not read file %s: %s.", filename, strerror(errno));
         noh_return_defer(false);
     }
 
 defer:
-    free(buf);
     if (f) fclose(f);
     return result;
 }
@@ -742,15 +1504,15 @@ static void increase_sv_position(Noh_String_View *sv, size_t distance) {
         sv->count -= distance;
         sv->elems += distance;
     } else {
-        sv->count = 0;
         sv->elems += sv->count;
+        sv->count = 0;
     }
 }
 
 Noh_String_View noh_sv_chop_by_delim(Noh_String_View *sv, char delim) {
-    size_t i = 0;
     // Find the character, or the end of the string view.
-    while (i < sv->count && sv->elems[i] != delim) i++;
+    const char *found = sv->count > 0 ? memchr(sv->elems, delim, sv->count) : NULL;
+    size_t i = found != NULL ? (size_t)(found - sv->elems) : sv->count;
 
     // The data until the delimiter is returned.
     Noh_String_View result = { .count = i, .elems = sv->elems };
@@ -761,6 +1523,17 @@ Noh_String_View noh_sv_chop_by_delim(Noh_String_View *sv, char delim) {
     return result;
 }
 
+Noh_String_View noh_sv_chop_by_space(Noh_String_View *sv) {
+    size_t start = 0;
+    while (start < sv->count && isspace((unsigned char)sv->elems[start])) start++;
+    size_t end = start;
+    while (end < sv->count && !isspace((unsigned char)sv->elems[end])) end++;
+
+    Noh_String_View result = { .count = end - start, .elems = sv->elems + start };
+    increase_sv_position(sv, end);
+    return result;
+}
+
 void noh_sv_trim_left(Noh_String_View *sv, bool (*do_trim)(char)) {
     size_t i = 0;
     while (i < sv->count && (*do_trim)(sv->elems[i])) i++;
@@ -903,6 +1676,51 @@ bool noh_rename(const char *path, const char *new_path)
     return true;
 }
 
+bool noh_file_map(Noh_File_Map *map, const char *path) {
+    *map = (Noh_File_Map) {0};
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        noh_log(NOH_ERROR, "Could not open file %s: %s.", path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (data != MAP_FAILED) {
+        madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+        map->contents.elems = data;
+        map->contents.count = (size_t)st.st_size;
+        map->mapped = true;
+        return true;
+    }
+#endif // _WIN32
+
+    // Empty files, and files that can't be mapped, are read instead.
+    Noh_String contents = {0};
+    if (!noh_string_read_file(&contents, path)) {
+        noh_string_free(&contents);
+        return false;
+    }
+    map->contents.elems = contents.elems;
+    map->contents.count = contents.count;
+    return true;
+}
+
+void noh_file_unmap(Noh_File_Map *map) {
+#ifndef _WIN32
+    if (map->mapped) munmap((void *)map->contents.elems, map->contents.count);
+#endif // _WIN32
+    if (!map->mapped) free((void *)map->contents.elems);
+    *map = (Noh_File_Map) {0};
+}
+
 bool noh_remove(const char *path) {
     noh_log(NOH_INFO, "Removing '%s'.", path);
     if (remove(path) < 0) { 
@@ -0,0 +1,393 @@
+#include <ctype.h>
+#include <math.h>
+#include "points.h"
+
+///////////////////////// Point index /////////////////////////
+
+#define POINT_INDEX_INIT_CAP 256
+
+// Hashes a grid cell, the slot is found by masking the result with the capacity.
+static size_t hash_cell(int x, int y) {
+    uint64 h = (uint64)(uint)x * 0x9E3779B97F4A7C15ul ^ (uint64)(uint)y * 0xC2B2AE3D27D4EB4Ful;
+    h ^= h >> 29;
+    return (size_t)h;
+}
+
+// Returns the slot for the specified cell, this is either the slot holding the cell, or the empty slot where it
+// would be inserted. Requires that the index has at least one empty slot.
+static Point_Index_Slot *find_slot(Point_Index *index, int x, int y) {
+    size_t mask = index->capacity - 1;
+    size_t i = hash_cell(x, y) & mask;
+    for (;;) {
+        Point_Index_Slot *slot = &index->slots[i];
+        if (slot->index == POINT_INDEX_EMPTY) return slot;
+        if (slot->x == x && slot->y == y) return slot;
+        i = (i + 1) & mask;
+    }
+}
+
+// Grows the index to the specified capacity, re-inserting all cells.
+static void grow_index(Point_Index *index, size_t new_cap) {
+    Point_Index_Slot *old_slots = index->slots;
+    size_t old_cap = index->capacity;
+
+    index->slots = noh_realloc_check(NULL, new_cap * sizeof(Point_Index_Slot));
+    index->capacity = new_cap;
+    for (size_t i = 0; i < new_cap; i++) index->slots[i].index = POINT_INDEX_EMPTY;
+
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old_slots[i].index == POINT_INDEX_EMPTY) continue;
+        *find_slot(index, old_slots[i].x, old_slots[i].y) = old_slots[i];
+    }
+
+    free(old_slots);
+}
+
+size_t point_index_find(Point_Index *index, int x, int y) {
+    if (index->count == 0) return POINT_INDEX_EMPTY;
+    return find_slot(index, x, y)->index;
+}
+
+bool point_index_insert(Point_Index *index, int x, int y, size_t point_index) {
+    // Keep the load factor at or below one half, so probe sequences stay short.
+    if ((index->count + 1) * 2 > index->capacity) {
+        grow_index(index, index->capacity == 0 ? POINT_INDEX_INIT_CAP : index->capacity * 2);
+    }
+
+    Point_Index_Slot *slot = find_slot(index, x, y);
+    if (slot->index != POINT_INDEX_EMPTY) {
+        index->shadowed++;
+        return false;
+    }
+
+    slot->x = x;
+    slot->y = y;
+    slot->index = point_index;
+    index->count++;
+    return true;
+}
+
+void point_index_set(Point_Index *index, int x, int y, size_t point_index) {
+    noh_assert(index->count > 0 && "Cell is not in the index.");
+    Point_Index_Slot *slot = find_slot(index, x, y);
+    noh_assert(slot->index != POINT_INDEX_EMPTY && "Cell is not in the index.");
+    slot->index = point_index;
+}
+
+void point_index_remove(Point_Index *index, int x, int y) {
+    if (index->count == 0) return;
+
+    Point_Index_Slot *slot = find_slot(index, x, y);
+    if (slot->index == POINT_INDEX_EMPTY) return;
+
+    // Backward shift deletion: move later slots of the probe sequence into the gap, so no tombstones are needed.
+    size_t mask = index->capacity - 1;
+    size_t gap = slot - index->slots;
+    size_t i = gap;
+    for (;;) {
+        i = (i + 1) & mask;
+        Point_Index_Slot *next = &index->slots[i];
+        if (next->index == POINT_INDEX_EMPTY) break;
+
+        // Only move the slot if its home position is not between the gap and its current position.
+        size_t home = hash_cell(next->x, next->y) & mask;
+        if (((i - home) & mask) >= ((i - gap) & mask)) {
+            index->slots[gap] = *next;
+            gap = i;
+        }
+    }
+
+    index->slots[gap].index = POINT_INDEX_EMPTY;
+    index->count--;
+}
+
+void point_index_reset(Point_Index *index) {
+    for (size_t i = 0; i < index->capacity; i++) index->slots[i].index = POINT_INDEX_EMPTY;
+    index->count = 0;
+    index->shadowed = 0;
+}
+
+void point_index_free(Point_Index *index) {
+    free(index->slots);
+    index->slots = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->shadowed = 0;
+}
+
+///////////////////////// Points /////////////////////////
+
+// Indicates whether a position lies exactly on a grid cell, only those positions are indexed.
+static bool is_cell(Vector2 pos) {
+    return pos.x == truncf(pos.x) && pos.y == truncf(pos.y)
+        && fabsf(pos.x) < (float)(1 << 30) && fabsf(pos.y) < (float)(1 << 30);
+}
+
+// Adds the point at the specified index to the point index.
+static void index_point(Points *points, size_t i) {
+    Vector2 pos = points->elems[i];
+    if (is_cell(pos)) point_index_insert(&points->index, (int)pos.x, (int)pos.y, i);
+}
+
+// Builds the index of a layer that was loaded without one.
+static void ensure_index(Points *points) {
+    if (!points->unindexed) return;
+    points->unindexed = false;
+    point_index_reset(&points->index);
+    for (size_t i = 0; i < points->count; i++) index_point(points, i);
+}
+
+// Copies the points of a mapped layer to the heap, so they can be edited.
+static void own_points(Points *points) {
+    if (!points->mapped) return;
+    Vector2 *elems = noh_realloc_check(NULL, points->count * sizeof(Vector2));
+    memcpy(elems, points->elems, points->count * sizeof(Vector2));
+    points->elems = elems;
+    points->capacity = points->count;
+    points->mapped = false;
+}
+
+// Frees the points of a layer, unless they are mapped.
+static void free_points(Points *points) {
+    if (!points->mapped) free(points->elems);
+    points->elems = NULL;
+    points->count = 0;
+    points->capacity = 0;
+    points->mapped = false;
+}
+
+int points_find(Points *points, Vector2 pos) {
+    ensure_index(points);
+    if (is_cell(pos)) {
+        size_t i = point_index_find(&points->index, (int)pos.x, (int)pos.y);
+        return i == POINT_INDEX_EMPTY ? -1 : (int)i;
+    }
+
+    // Positions off the grid are not indexed, these are rare enough to just scan for.
+    for (size_t i = 0; i < points->count; i++) {
+        if (points->elems[i].x == pos.x && points->elems[i].y == pos.y) return (int)i;
+    }
+
+    return -1;
+}
+
+// Returns the bits of a float as an int, with negative zero folded into zero so equal positions get equal keys.
+static int float_key(float f) {
+    f += 0.0f;
+    int key;
+    memcpy(&key, &f, sizeof(key));
+    return key;
+}
+
+void points_vertex_ids(Points *points, uint *ids) {
+    ensure_index(points);
+
+    // Positions off the grid, like those of imported meshes, are not in the point index. Rather than scanning for each
+    // of them, they are put in a temporary index keyed on their exact bits, the first point at a position wins.
+    Point_Index off_grid = {0};
+    for (size_t i = 0; i < points->count; i++) {
+        Vector2 pos = points->elems[i];
+        if (is_cell(pos)) {
+            ids[i] = (uint)point_index_find(&points->index, (int)pos.x, (int)pos.y);
+            continue;
+        }
+
+        int x = float_key(pos.x), y = float_key(pos.y);
+        if (!point_index_insert(&off_grid, x, y, i)) ids[i] = (uint)point_index_find(&off_grid, x, y);
+        else ids[i] = (uint)i;
+    }
+    point_index_free(&off_grid);
+}
+
+void points_rebuild_index(Points *points) {
+    points->version++;
+    points->unindexed = false;
+    point_index_reset(&points->index);
+    for (size_t i = 0; i < points->count; i++) index_point(points, i);
+}
+
+bool points_compact(Points *points) {
+    if (points->compact) return true;
+    if (points->count == 0) return false;
+    if (!quant_encode(&points->quantized, points->elems, points->count)) return false;
+
+    size_t count = points->count;
+    free_points(points);
+    points->count = count;
+    point_index_free(&points->index);
+    points->unindexed = false;
+    points->compact = true;
+    return true;
+}
+
+void points_expand(Points *points) {
+    if (!points->compact) return;
+
+    size_t count = points->count;
+    points->elems = noh_realloc_check(NULL, count * sizeof(Vector2));
+    points->capacity = count;
+    quant_decode(&points->quantized, points->elems);
+    quant_free(&points->quantized);
+    points->compact = false;
+
+    // The points did not change, so the version stays the same.
+    point_index_reset(&points->index);
+    for (size_t i = 0; i < count; i++) index_point(points, i);
+}
+
+size_t points_memory(Points *points) {
+    if (points->compact) return quant_memory(&points->quantized);
+    size_t elems_memory = points->mapped ? 0 : points->capacity * sizeof(Vector2);
+    return elems_memory + points->index.capacity * sizeof(Point_Index_Slot);
+}
+
+void points_free(Points *points) {
+    free_points(points);
+    point_index_free(&points->index);
+    quant_free(&points->quantized);
+    points->compact = false;
+}
+
+void add_point(Points *points, Vector2 pos) {
+    if (points_find(points, pos) >= 0) return;
+
+    own_points(points);
+    Vector2 new_point = { .x = pos.x, .y = pos.y };
+    noh_da_append(points, new_point);
+    index_point(points, points->count - 1);
+    points->version++;
+}
+
+void remove_point(Points *points, Vector2 pos) {
+    int point_index = points_find(points, pos);
+    if (point_index == -1) return;
+
+    own_points(points);
+    noh_da_remove_at(points, (size_t)point_index);
+    points->version++;
+
+    // Removing a point shifts all later points, so these need to be re-indexed. This is linear anyway because of the
+    // memmove, but only touches the tail of the layer.
+    if (points->index.shadowed > 0) {
+        points_rebuild_index(points);
+        return;
+    }
+
+    if (is_cell(pos)) point_index_remove(&points->index, (int)pos.x, (int)pos.y);
+    for (size_t i = point_index; i < points->count; i++) {
+        Vector2 p = points->elems[i];
+        if (is_cell(p)) point_index_set(&points->index, (int)p.x, (int)p.y, i);
+    }
+}
+
+int start_moving(Points *points, Vector2 pos) {
+    return points_find(points, pos);
+}
+
+void stop_moving(Points *points, int moving_index, Vector2 pos) {
+    // If there is already another point at the target position, don't do anything.
+    if (points_find(points, pos) >= 0) return;
+
+    own_points(points);
+    Vector2 old_pos = points->elems[moving_index];
+    points->elems[moving_index].x = pos.x;
+    points->elems[moving_index].y = pos.y;
+    points->version++;
+
+    // A shadowed point may have to take over the old cell, only a rebuild can find it.
+    if (points->index.shadowed > 0) {
+        points_rebuild_index(points);
+        return;
+    }
+
+    if (is_cell(old_pos)) point_index_remove(&points->index, (int)old_pos.x, (int)old_pos.y);
+    index_point(points, moving_index);
+}
+
+void move_point_index(Points *points, Vector2 pos, int direction) {
+    int point_index = points_find(points, pos);
+
+    if (point_index == -1) return;
+    if (point_index + direction < 0) return;
+    if (point_index + direction >= (int)points->count) return;
+
+    own_points(points);
+    int other_index = point_index + direction;
+    Vector2 temp = points->elems[point_index];
+    points->elems[point_index] = points->elems[other_index];
+    points->elems[other_index] = temp;
+    points->version++;
+
+    // Swapping points with shadowed duplicates may change which of them comes first.
+    if (points->index.shadowed > 0) {
+        points_rebuild_index(points);
+        return;
+    }
+
+    Vector2 a = points->elems[point_index];
+    Vector2 b = points->elems[other_index];
+    if (is_cell(a)) point_index_set(&points->index, (int)a.x, (int)a.y, point_index);
+    if (is_cell(b)) point_index_set(&points->index, (int)b.x, (int)b.y, other_index);
+}
+
+///////////////////////// Layers /////////////////////////
+
+// Parses a line holding the x and y coordinate of a point.
+static bool parse_point(Noh_String_View line, Vector2 *point) {
+    char buf[64];
+    if (line.count >= sizeof(buf)) return false;
+    memcpy(buf, line.elems, line.count);
+    buf[line.count] = '\0';
+
+    char *end_x, *end_y;
+    point->x = strtof(buf, &end_x);
+    point->y = strtof(end_x, &end_y);
+    if (end_x == buf || end_y == end_x) return false;
+
+    while (isspace(*end_y)) end_y++;
+    return *end_y == '\0';
+}
+
+bool layers_load_text(Layers *layers, const char *path) {
+    bool result = true;
+    Noh_File_Map file = {0};
+    if (!noh_file_map(&file, path)) noh_return_defer(false);
+
+    Points empty = {0};
+    noh_da_append(layers, empty);
+
+    Noh_String_View sv = file.contents;
+    for (size_t line_number = 1; sv.count > 0; line_number++) {
+        Noh_String_View line = noh_sv_chop_by_delim(&sv, '\n');
+        noh_sv_trim_space_left(&line);
+        noh_sv_trim_space_right(&line);
+
+        Points *points = &layers->elems[layers->count - 1];
+        if (line.count == 0) {
+            if (points->count > 0) noh_da_append(layers, empty);
+            continue;
+        }
+
+        Vector2 point;
+        if (!parse_point(line, &point)) {
+            noh_log(NOH_ERROR, "%s:%zu: Expected two coordinates, got '"Nsv_Fmt"'.", path, line_number,
+                Nsv_Arg(line));
+            noh_return_defer(false);
+        }
+        add_point(points, point);
+    }
+
+    // Don't keep an empty layer from trailing empty lines, unless it is the only one.
+    if (layers->count > 1 && layers->elems[layers->count - 1].count == 0) {
+        points_free(&layers->elems[--layers->count]);
+    }
+
+defer:
+    noh_file_unmap(&file);
+    return result;
+}
+
+void layers_free(Layers *layers) {
+    for (size_t i = 0; i < layers->count; i++) points_free(&layers->elems[i]);
+    noh_da_free(layers);
+}
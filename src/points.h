@@ -0,0 +1,127 @@
+#ifndef POINTS_H_
+#define POINTS_H_
+
+#include <raylib.h>
+#include "noh.h"
+#include "mesh.h"
+#include "quant.h"
+
+///////////////////////// Point index /////////////////////////
+
+#define POINT_INDEX_EMPTY ((size_t)-1)
+
+// A slot in a point index, maps a grid cell to the index of the point at that cell.
+typedef struct {
+    int x;
+    int y;
+    size_t index; // POINT_INDEX_EMPTY if the slot is not in use.
+} Point_Index_Slot;
+
+// An open addressing hash table from grid cells to point indexes, kept in sync with a Points layer.
+// Only points on integer grid cells are indexed. If a cell holds more than one point, only the first one is indexed,
+// the others are counted as shadowed.
+typedef struct {
+    Point_Index_Slot *slots;
+    size_t count;
+    size_t capacity; // Always a power of two, or 0.
+    size_t shadowed;
+} Point_Index;
+
+// Returns the index of the point at the specified cell, or POINT_INDEX_EMPTY if there is none.
+size_t point_index_find(Point_Index *index, int x, int y);
+
+// Maps the specified cell to a point index. If the cell is already mapped, it is not overwritten.
+// Returns whether the cell was inserted.
+bool point_index_insert(Point_Index *index, int x, int y, size_t point_index);
+
+// Updates the point index that the specified cell maps to. The cell must be in the index.
+void point_index_set(Point_Index *index, int x, int y, size_t point_index);
+
+// Removes the specified cell from the index, if it is present.
+void point_index_remove(Point_Index *index, int x, int y);
+
+// Removes all cells from the index, keeping the slots allocated.
+void point_index_reset(Point_Index *index);
+
+// Frees the slots of the index.
+void point_index_free(Point_Index *index);
+
+///////////////////////// Points /////////////////////////
+
+// A single layer of points, in grid coordinates, forming a triangle strip in order.
+// A mapped layer has its points in a mapped session file, these are copied to the heap on the first edit.
+// A compact layer has its points only in quantized form, elems is NULL while count still holds the number of points.
+// Such a layer needs to be expanded before it can be used in any other way.
+typedef struct {
+    Vector2 *elems;
+    size_t count;
+    size_t capacity;
+
+    Point_Index index;
+    bool unindexed; // The index still needs to be built, it is built on first use.
+    size_t version; // Increased on every edit, so derived data knows when to update.
+    Layer_Mesh mesh;
+
+    bool mapped;
+    bool compact;
+    Quant_Points quantized;
+} Points;
+
+typedef struct {
+    Points *elems;
+    size_t count;
+    size_t capacity;
+
+    size_t active_layer;
+    int comparison_layer; // I want to use -1 to indicate no comparison.
+} Layers;
+
+// Returns the index of the point at the specified position, or -1 if there is no point there.
+int points_find(Points *points, Vector2 pos);
+
+// Writes, for every point of a layer, the index of the first point at the same position, so points that are repeated in
+// the strip are identified as the same vertex.
+void points_vertex_ids(Points *points, uint *ids);
+
+// Rebuilds the index of a layer from its points and marks it as edited. Needed after modifying the points directly.
+void points_rebuild_index(Points *points);
+
+// Replaces the points of a layer by their quantized form and frees the index. The mesh needs to be unloaded
+// separately. Fails, leaving the layer as it is, if the points can't be quantized.
+bool points_compact(Points *points);
+
+// Restores the points and the index of a compact layer, does nothing for other layers.
+void points_expand(Points *points);
+
+// Returns the number of bytes of memory used by the points of a layer, including the index. Mapped points are not
+// counted, the pages of these can be dropped by the operating system at any time.
+size_t points_memory(Points *points);
+
+// Frees the points and the index of a layer. The mesh needs to be unloaded separately, since it lives on the GPU.
+void points_free(Points *points);
+
+// Adds a point at the end of the layer, if there is no point at the specified position yet.
+void add_point(Points *points, Vector2 pos);
+
+// Removes the point at the specified position, if there is one.
+void remove_point(Points *points, Vector2 pos);
+
+// Returns the index of the point to start moving, or -1 if there is no point at the specified position.
+int start_moving(Points *points, Vector2 pos);
+
+// Moves the point being moved to the specified position, unless there is already a point there.
+void stop_moving(Points *points, int moving_index, Vector2 pos);
+
+// Moves the point at the specified position one place up or down in the triangle strip.
+void move_point_index(Points *points, Vector2 pos, int direction);
+
+///////////////////////// Layers /////////////////////////
+
+// Appends the layers in a text file to the specified layers. Every line holds the x and y grid coordinate of a point,
+// separated by whitespace, and empty lines separate layers. Returns whether the file could be read and parsed.
+bool layers_load_text(Layers *layers, const char *path);
+
+// Frees all layers. Their meshes need to be unloaded separately.
+void layers_free(Layers *layers);
+
+#endif // POINTS_H_
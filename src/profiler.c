@@ -0,0 +1,143 @@
+#include "profiler.h"
+
+// Frame times at or above this fill the whole height of the graph.
+#define PROFILER_GRAPH_MAX_NS (1000ul * 1000 * 1000 / 30)
+
+static struct {
+    Profile_Frames frames;
+    Profile_Frame current;
+    uint64 zone_start[PROFILE_ZONE_COUNT];
+    uint64 frame_start;
+} profiler = {0};
+
+static Color zone_colors[PROFILE_ZONE_COUNT] = {
+    [PROFILE_INPUT] = YELLOW,
+    [PROFILE_GRID] = SKYBLUE,
+    [PROFILE_LAYERS] = RED,
+    [PROFILE_ANIMATION] = VIOLET,
+    [PROFILE_END_DRAWING] = DARKGRAY,
+};
+
+void profiler_init(size_t history) {
+    noh_cb_initialize(&profiler.frames, history);
+    profiler.frame_start = noh_time_ns();
+}
+
+void profiler_free() {
+    noh_da_free(&profiler.frames);
+}
+
+void profile_begin(Profile_Zone zone) {
+    noh_trace_begin(profile_zone_name(zone));
+    profiler.zone_start[zone] = noh_time_ns();
+}
+
+void profile_end(Profile_Zone zone) {
+    profiler.current.zone_ns[zone] += noh_time_ns() - profiler.zone_start[zone];
+    noh_trace_end(profile_zone_name(zone));
+}
+
+void profiler_frame_end() {
+    uint64 now = noh_time_ns();
+    profiler.current.frame_ns = now - profiler.frame_start;
+    noh_cb_insert(&profiler.frames, profiler.current);
+
+    memset(&profiler.current, 0, sizeof(profiler.current));
+    profiler.frame_start = now;
+}
+
+const char *profile_zone_name(Profile_Zone zone) {
+    switch (zone) {
+        case PROFILE_INPUT: return "input";
+        case PROFILE_GRID: return "grid";
+        case PROFILE_LAYERS: return "layers";
+        case PROFILE_ANIMATION: return "animation";
+        case PROFILE_END_DRAWING: return "end drawing";
+        default: noh_assert(false && "Invalid profile zone");
+    }
+    return NULL;
+}
+
+// Returns the frame in the history at the specified age, 0 being the oldest frame.
+static Profile_Frame *frame_at(size_t i) {
+    return &profiler.frames.elems[(profiler.frames.start + i) % profiler.frames.count];
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64 x = *(const uint64 *)a;
+    uint64 y = *(const uint64 *)b;
+    return (x > y) - (x < y);
+}
+
+void profiler_draw_overlay(Noh_Arena *arena, Rectangle bounds) {
+    size_t count = profiler.frames.count;
+    DrawRectangleRec(bounds, Fade(BLACK, 0.8));
+    if (count == 0) return;
+
+    // Stacked bars of the zone times of each frame, the remainder of the frame in gray.
+    float bar_width = bounds.width / profiler.frames.capacity;
+    float graph_height = bounds.height / 2;
+    float graph_bottom = bounds.y + bounds.height;
+    for (size_t i = 0; i < count; i++) {
+        Profile_Frame *frame = frame_at(i);
+        float x = bounds.x + i * bar_width;
+        float y = graph_bottom;
+
+        float frame_h = min((float)frame->frame_ns / PROFILER_GRAPH_MAX_NS, 1.0f) * graph_height;
+        DrawRectangleRec(CLITERAL(Rectangle) { x, y - frame_h, bar_width, frame_h }, Fade(GRAY, 0.3));
+
+        for (int z = 0; z < PROFILE_ZONE_COUNT; z++) {
+            float h = (float)frame->zone_ns[z] / PROFILER_GRAPH_MAX_NS * graph_height;
+            h = min(h, y - (graph_bottom - graph_height));
+            y -= h;
+            DrawRectangleRec(CLITERAL(Rectangle) { x, y, bar_width, h }, zone_colors[z]);
+        }
+    }
+
+    // 16.7 ms line, the budget of a frame at 60 fps.
+    float budget_y = graph_bottom - graph_height * (1000.0 / 60) / (PROFILER_GRAPH_MAX_NS / 1e6);
+    DrawLineV(CLITERAL(Vector2) { bounds.x, budget_y }, CLITERAL(Vector2) { bounds.x + bounds.width, budget_y }, LIME);
+
+    // Percentiles per zone.
+    Noh_Arena_Mark mark = noh_arena_mark(arena);
+    uint64 *values = noh_arena_push(arena, uint64, count);
+    float text_y = bounds.y + 5;
+    for (int z = 0; z <= PROFILE_ZONE_COUNT; z++) {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = z == PROFILE_ZONE_COUNT ? frame_at(i)->frame_ns : frame_at(i)->zone_ns[z];
+        }
+        qsort(values, count, sizeof(uint64), compare_u64);
+        double p50 = values[count / 2] / 1e6;
+        double p99 = values[min(count - 1, count * 99 / 100)] / 1e6;
+
+        const char *name = z == PROFILE_ZONE_COUNT ? "frame" : profile_zone_name(z);
+        Color color = z == PROFILE_ZONE_COUNT ? LIGHTGRAY : zone_colors[z];
+        char *text = noh_arena_sprintf(arena, "%-12s p50 %7.3f ms  p99 %7.3f ms", name, p50, p99);
+        DrawText(text, bounds.x + 5, text_y, 10, color);
+        text_y += 12;
+    }
+    noh_arena_rewind_to(arena, mark);
+}
+
+void profiler_draw_arena_overlay(Noh_Arena *arena, Rectangle bounds) {
+    Noh_Arena_Stats stats = noh_arena_stats(arena);
+    DrawRectangleRec(bounds, Fade(BLACK, 0.8));
+
+    noh_arena_temp(arena) {
+        const char *lines[] = {
+            noh_arena_sprintf(arena, "size     %10.1f KB  capacity %8.1f KB", stats.size / 1024.0,
+                stats.capacity / 1024.0),
+            noh_arena_sprintf(arena, "peak     %10.1f KB", stats.peak_size / 1024.0),
+            noh_arena_sprintf(arena, "frame    %10.1f KB  in %zu allocations", stats.frame_allocated / 1024.0,
+                stats.frame_allocations),
+            noh_arena_sprintf(arena, "total    %10.1f MB  in %zu allocations", stats.allocated / (1024.0 * 1024.0),
+                stats.allocations),
+            noh_arena_sprintf(arena, "blocks   %10zu created, %zu freed", stats.blocks_created, stats.blocks_freed),
+            noh_arena_sprintf(arena, "checkpoints %7zu  peak %zu", stats.checkpoint_depth,
+                stats.peak_checkpoint_depth),
+        };
+        for (size_t i = 0; i < noh_array_len(lines); i++) {
+            DrawText(lines[i], bounds.x + 5, bounds.y + 5 + i * 12, 10, LIGHTGRAY);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <raylib.h>
+#include "noh.h"
+
+// A per-frame profiler. Time spent in each zone is summed per frame, and the last frames are kept in a circular
+// buffer so they can be shown in an overlay.
+
+typedef enum {
+    PROFILE_INPUT,
+    PROFILE_GRID,
+    PROFILE_LAYERS,
+    PROFILE_ANIMATION,
+    PROFILE_END_DRAWING,
+    PROFILE_ZONE_COUNT,
+} Profile_Zone;
+
+// The time spent in each zone during a single frame.
+typedef struct {
+    uint64 zone_ns[PROFILE_ZONE_COUNT];
+    uint64 frame_ns;
+} Profile_Frame;
+
+typedef struct {
+    Profile_Frame *elems;
+    size_t count;
+    size_t capacity;
+    size_t start;
+} Profile_Frames;
+
+// Initializes the profiler, keeping the specified number of frames of history.
+void profiler_init(size_t history);
+
+// Frees the history of the profiler.
+void profiler_free();
+
+// Starts timing a zone. Zones can be entered multiple times per frame, their times are added. Zones are also recorded
+// as trace spans if tracing is initialized.
+void profile_begin(Profile_Zone zone);
+
+// Stops timing a zone.
+void profile_end(Profile_Zone zone);
+
+// Times the statement or block that follows it as the specified zone.
+// Usage:
+//   profile_zone(PROFILE_GRID) draw_grid_and_axes(center);
+#define profile_zone(zone) \
+    for (int profile_once_ = (profile_begin(zone), 0); !profile_once_; profile_once_ = (profile_end(zone), 1))
+
+// Ends the current frame, storing its times in the history.
+void profiler_frame_end();
+
+// Returns a readable name of a zone.
+const char *profile_zone_name(Profile_Zone zone);
+
+// Draws a graph of the frame times in the history, with the p50 and p99 of each zone, in the specified rectangle.
+// The arena is only used for temporary data.
+void profiler_draw_overlay(Noh_Arena *arena, Rectangle bounds);
+
+// Draws the stats of an arena in the specified rectangle. The stats are taken before the arena is used for the text.
+// Most stats are only counted if NOH_ARENA_STATS is defined.
+void profiler_draw_arena_overlay(Noh_Arena *arena, Rectangle bounds);
+
+#endif // PROFILER_H_
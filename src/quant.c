@@ -0,0 +1,153 @@
+#include <math.h>
+#include "quant.h"
+#include "transform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define QUANT_X86
+#include <immintrin.h>
+#endif // __x86_64__ || __i386__
+
+///////////////////////// Encoding /////////////////////////
+
+bool quant_encode(Quant_Points *quant, const Vector2 *points, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (points[i].x != truncf(points[i].x) || points[i].y != truncf(points[i].y)) return false;
+        if (fabsf(points[i].x) >= (float)(1 << 30) || fabsf(points[i].y) >= (float)(1 << 30)) return false;
+    }
+
+    Quant_Points result = { .count = count };
+    result.block_count = (count + QUANT_BLOCK_POINTS - 1) / QUANT_BLOCK_POINTS;
+    result.blocks = noh_realloc_check(NULL, (result.block_count + 1) * sizeof(Quant_Block));
+
+    // Size the blocks first, so the data is allocated once.
+    for (size_t b = 0; b < result.block_count; b++) {
+        Quant_Block *block = &result.blocks[b];
+        const Vector2 *block_points = points + b * QUANT_BLOCK_POINTS;
+        block->count = (uint)min(count - b * QUANT_BLOCK_POINTS, (size_t)QUANT_BLOCK_POINTS);
+
+        int min_x = INT32_MAX, min_y = INT32_MAX, max_x = INT32_MIN, max_y = INT32_MIN;
+        for (uint i = 0; i < block->count; i++) {
+            min_x = min(min_x, (int)block_points[i].x);
+            min_y = min(min_y, (int)block_points[i].y);
+            max_x = max(max_x, (int)block_points[i].x);
+            max_y = max(max_y, (int)block_points[i].y);
+        }
+        if ((long)max_x - min_x > UINT16_MAX || (long)max_y - min_y > UINT16_MAX) {
+            free(result.blocks);
+            return false;
+        }
+
+        block->base_x = min_x;
+        block->base_y = min_y;
+        block->wide = max_x - min_x > UINT8_MAX || max_y - min_y > UINT8_MAX;
+        block->offset = result.data_size;
+        result.data_size += block->count * 2 * (block->wide ? 2 : 1);
+    }
+
+    result.data = noh_realloc_check(NULL, result.data_size + 1);
+    for (size_t b = 0; b < result.block_count; b++) {
+        Quant_Block *block = &result.blocks[b];
+        const Vector2 *block_points = points + b * QUANT_BLOCK_POINTS;
+        for (uint i = 0; i < block->count; i++) {
+            uint dx = (uint)((int)block_points[i].x - block->base_x);
+            uint dy = (uint)((int)block_points[i].y - block->base_y);
+            if (block->wide) {
+                uint16_t *offsets = (uint16_t *)(result.data + block->offset);
+                offsets[2 * i] = (uint16_t)dx;
+                offsets[2 * i + 1] = (uint16_t)dy;
+            } else {
+                uint8 *offsets = result.data + block->offset;
+                offsets[2 * i] = (uint8)dx;
+                offsets[2 * i + 1] = (uint8)dy;
+            }
+        }
+    }
+
+    *quant = result;
+    return true;
+}
+
+size_t quant_memory(const Quant_Points *quant) {
+    return quant->block_count * sizeof(Quant_Block) + quant->data_size;
+}
+
+void quant_free(Quant_Points *quant) {
+    free(quant->blocks);
+    free(quant->data);
+    *quant = (Quant_Points) {0};
+}
+
+///////////////////////// Decoding /////////////////////////
+
+static void block_to_screen_scalar(const Quant_Points *quant, const Quant_Block *block, Vector2 *out, float scale,
+    Vector2 offset) {
+    for (uint i = 0; i < block->count; i++) {
+        int dx, dy;
+        if (block->wide) {
+            const uint16_t *offsets = (const uint16_t *)(quant->data + block->offset);
+            dx = offsets[2 * i];
+            dy = offsets[2 * i + 1];
+        } else {
+            const uint8 *offsets = quant->data + block->offset;
+            dx = offsets[2 * i];
+            dy = offsets[2 * i + 1];
+        }
+        out[i].x = offset.x + (float)(block->base_x + dx) * scale;
+        out[i].y = offset.y + (float)(block->base_y + dy) * scale;
+    }
+}
+
+#ifdef QUANT_X86
+
+// Four points per iteration. The offsets are zero extended to 32 bits, the base is added as integers so large
+// coordinates stay exact, and then they are converted and transformed as two registers of two Vector2 each.
+__attribute__((target("sse2")))
+static void block_to_screen_sse(const Quant_Points *quant, const Quant_Block *block, Vector2 *out, float scale,
+    Vector2 offset) {
+    __m128i base = _mm_setr_epi32(block->base_x, block->base_y, block->base_x, block->base_y);
+    __m128 s = _mm_set1_ps(scale);
+    __m128 o = _mm_setr_ps(offset.x, offset.y, offset.x, offset.y);
+    __m128i zero = _mm_setzero_si128();
+    float *dst = (float *)out;
+    const uint8 *data = quant->data + block->offset;
+
+    uint i = 0;
+    for (; i + 4 <= block->count; i += 4) {
+        __m128i offsets16;
+        if (block->wide) {
+            offsets16 = _mm_loadu_si128((const __m128i *)(data + 4 * i));
+        } else {
+            offsets16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(data + 2 * i)), zero);
+        }
+
+        __m128i lo = _mm_add_epi32(_mm_unpacklo_epi16(offsets16, zero), base);
+        __m128i hi = _mm_add_epi32(_mm_unpackhi_epi16(offsets16, zero), base);
+        _mm_storeu_ps(dst + 2 * i, _mm_add_ps(o, _mm_mul_ps(_mm_cvtepi32_ps(lo), s)));
+        _mm_storeu_ps(dst + 2 * i + 4, _mm_add_ps(o, _mm_mul_ps(_mm_cvtepi32_ps(hi), s)));
+    }
+
+    if (i < block->count) {
+        Quant_Block tail = *block;
+        tail.count = block->count - i;
+        tail.offset = block->offset + i * 2 * (block->wide ? 2 : 1);
+        block_to_screen_scalar(quant, &tail, out + i, scale, offset);
+    }
+}
+
+#endif // QUANT_X86
+
+void quant_to_screen(const Quant_Points *quant, Vector2 *out, float scale, Vector2 offset) {
+    void (*block_to_screen)(const Quant_Points *, const Quant_Block *, Vector2 *, float, Vector2) =
+        block_to_screen_scalar;
+#ifdef QUANT_X86
+    if (transform_best_kernel() != TRANSFORM_SCALAR) block_to_screen = block_to_screen_sse;
+#endif // QUANT_X86
+
+    for (size_t b = 0; b < quant->block_count; b++) {
+        block_to_screen(quant, &quant->blocks[b], out + b * QUANT_BLOCK_POINTS, scale, offset);
+    }
+}
+
+void quant_decode(const Quant_Points *quant, Vector2 *out) {
+    quant_to_screen(quant, out, 1, CLITERAL(Vector2) { 0 });
+}
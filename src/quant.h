@@ -0,0 +1,45 @@
+#ifndef QUANT_H_
+#define QUANT_H_
+
+#include <raylib.h>
+#include "noh.h"
+
+// Compact storage for layers with all points on integer grid cells. Points are split into blocks, every block stores
+// the lowest cell of its points and the offset of each point from it, as 8-bit offsets if the block is small enough
+// and as 16-bit offsets otherwise. That is 2 or 4 bytes per point, instead of 8 for a Vector2.
+
+#define QUANT_BLOCK_POINTS 256
+
+typedef struct {
+    int base_x;
+    int base_y;
+    uint count;
+    bool wide; // Offsets are 16-bit.
+    size_t offset; // The position of the offsets of the block in the data, as interleaved x and y offsets.
+} Quant_Block;
+
+typedef struct {
+    Quant_Block *blocks;
+    size_t block_count;
+    uint8 *data;
+    size_t data_size;
+    size_t count; // The number of points.
+} Quant_Points;
+
+// Encodes points in grid coordinates. Fails if a point is not on an integer cell, or if the points of a block are more
+// than 65535 cells apart.
+bool quant_encode(Quant_Points *quant, const Vector2 *points, size_t count);
+
+// Decodes the points to grid coordinates. The output needs room for quant->count points.
+void quant_decode(const Quant_Points *quant, Vector2 *out);
+
+// Decodes the points and converts them to screen coordinates, computing offset + point * scale.
+void quant_to_screen(const Quant_Points *quant, Vector2 *out, float scale, Vector2 offset);
+
+// Returns the number of bytes used by the encoded points.
+size_t quant_memory(const Quant_Points *quant);
+
+// Frees the encoded points.
+void quant_free(Quant_Points *quant);
+
+#endif // QUANT_H_
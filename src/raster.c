@@ -0,0 +1,344 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "raster.h"
+#include "transform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RASTER_X86
+#include <immintrin.h>
+#endif // __x86_64__ || __i386__
+
+// An edge function, which is positive on the inside of the edge. It is evaluated relative to the lower of its two
+// vertices, so the triangles on both sides of an edge compute exactly opposite values and no pixel is covered twice or
+// missed between them.
+typedef struct {
+    float a;
+    float b;
+    Vector2 origin;
+    bool top_left; // Whether pixel centers exactly on the edge are inside.
+} Edge;
+
+// Sets up the edge from p to q, for a triangle that is ordered clockwise on screen.
+static Edge edge_setup(Vector2 p, Vector2 q) {
+    Edge e = { .a = p.y - q.y, .b = q.x - p.x };
+    e.origin = p.y < q.y || (p.y == q.y && p.x < q.x) ? p : q;
+
+    // On screen, with y pointing down, top edges are horizontal going right and left edges go up.
+    e.top_left = q.y < p.y || (q.y == p.y && q.x > p.x);
+    return e;
+}
+
+static bool edge_inside(Edge e, float value) {
+    return value > 0 || (value == 0 && e.top_left);
+}
+
+///////////////////////// Spans /////////////////////////
+
+// Fills the pixels in [x0, x1) of a row that lie inside all three edges, sampling at pixel centers. The row starts at
+// pixel x0. Translucent colors are blended with the row.
+static void fill_span_scalar(Color *row, int x0, int x1, float y, Edge *edges, Color color) {
+    float rows[3];
+    for (int k = 0; k < 3; k++) rows[k] = edges[k].b * (y - edges[k].origin.y);
+
+    for (int x = x0; x < x1; x++) {
+        bool inside = true;
+        for (int k = 0; k < 3 && inside; k++) {
+            inside = edge_inside(edges[k], edges[k].a * ((x + 0.5f) - edges[k].origin.x) + rows[k]);
+        }
+        if (!inside) continue;
+        row[x - x0] = color.a == 255 ? color : ColorAlphaBlend(row[x - x0], color, WHITE);
+    }
+}
+
+#ifdef RASTER_X86
+
+static uint color_bits(Color color) {
+    uint bits;
+    memcpy(&bits, &color, sizeof(bits));
+    return bits;
+}
+
+// Four pixels per register. Fully covered groups are stored directly and partially covered groups are merged with the
+// row through the coverage mask. The last group of a span is written pixel by pixel, so nothing past the end of the
+// row is touched, but its coverage is still computed here so every pixel of a span is decided by the same arithmetic.
+__attribute__((target("sse2")))
+static void fill_span_sse(Color *row, int x0, int x1, float y, Edge *edges, Color color) {
+    if (color.a != 255) {
+        fill_span_scalar(row, x0, x1, y, edges, color);
+        return;
+    }
+
+    __m128 lanes = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    __m128 zero = _mm_setzero_ps();
+    __m128 a[3], origins[3], rows[3], top_left[3];
+    for (int k = 0; k < 3; k++) {
+        a[k] = _mm_set1_ps(edges[k].a);
+        origins[k] = _mm_set1_ps(edges[k].origin.x);
+        rows[k] = _mm_set1_ps(edges[k].b * (y - edges[k].origin.y));
+        top_left[k] = _mm_castsi128_ps(_mm_set1_epi32(edges[k].top_left ? -1 : 0));
+    }
+    __m128i fill = _mm_set1_epi32((int)color_bits(color));
+
+    for (int x = x0; x < x1; x += 4) {
+        __m128 px = _mm_add_ps(_mm_set1_ps((float)x), lanes);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int k = 0; k < 3; k++) {
+            __m128 value = _mm_add_ps(_mm_mul_ps(a[k], _mm_sub_ps(px, origins[k])), rows[k]);
+            __m128 edge = _mm_or_ps(_mm_cmpgt_ps(value, zero), _mm_and_ps(_mm_cmpeq_ps(value, zero), top_left[k]));
+            inside = _mm_and_ps(inside, edge);
+        }
+
+        int bits = _mm_movemask_ps(inside);
+        if (bits == 0) continue;
+        if (x + 4 > x1) {
+            for (int i = 0; i < x1 - x; i++) {
+                if (bits & (1 << i)) row[x - x0 + i] = color;
+            }
+            continue;
+        }
+
+        __m128i *dst = (__m128i *)(row + (x - x0));
+        if (bits == 0xF) {
+            _mm_storeu_si128(dst, fill);
+        } else {
+            __m128i mask = _mm_castps_si128(inside);
+            __m128i old = _mm_loadu_si128(dst);
+            _mm_storeu_si128(dst, _mm_or_si128(_mm_and_si128(mask, fill), _mm_andnot_si128(mask, old)));
+        }
+    }
+}
+
+#endif // RASTER_X86
+
+///////////////////////// Triangles /////////////////////////
+
+typedef void (*Fill_Span)(Color *row, int x0, int x1, float y, Edge *edges, Color color);
+
+// Returns the fastest span filler supported by the cpu running the program.
+static Fill_Span best_fill_span() {
+#ifdef RASTER_X86
+    if (transform_best_kernel() != TRANSFORM_SCALAR) return fill_span_sse;
+#endif // RASTER_X86
+    return fill_span_scalar;
+}
+
+// Counter-clockwise on screen is the front, which has a negative cross product with y pointing down. Degenerate
+// triangles have no front.
+static bool is_front(Geometry_Vertex *v) {
+    Vector2 a = v[0].position, b = v[1].position, c = v[2].position;
+    return (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y) < 0;
+}
+
+// Returns the pixels the bounding box of a triangle touches, clipped to a rectangle, as [x0, x1) x [y0, y1).
+static void triangle_bounds(Geometry_Vertex *v, int clip_x0, int clip_y0, int clip_x1, int clip_y1,
+    int *x0, int *y0, int *x1, int *y1) {
+    Vector2 a = v[0].position, b = v[1].position, c = v[2].position;
+    *x0 = max((int)floorf(fminf(a.x, fminf(b.x, c.x))), clip_x0);
+    *x1 = min((int)ceilf(fmaxf(a.x, fmaxf(b.x, c.x))), clip_x1);
+    *y0 = max((int)floorf(fminf(a.y, fminf(b.y, c.y))), clip_y0);
+    *y1 = min((int)ceilf(fmaxf(a.y, fmaxf(b.y, c.y))), clip_y1);
+}
+
+// The pixels that triangles are drawn into, either a whole image or a copy of one of its tiles. The pixels start at
+// pixel (x, y) of the image and rows are stride pixels apart.
+typedef struct {
+    Color *pixels;
+    int stride;
+    int x;
+    int y;
+} Raster_Target;
+
+// Fills the pixels of a front facing triangle within a rectangle of the target.
+static void draw_triangle(Raster_Target *target, Geometry_Vertex *v, Fill_Span fill_span,
+    int clip_x0, int clip_y0, int clip_x1, int clip_y1) {
+    // The triangle is flipped so its inside is positive.
+    Vector2 a = v[0].position, b = v[1].position, c = v[2].position;
+    Edge edges[3] = { edge_setup(a, c), edge_setup(c, b), edge_setup(b, a) };
+
+    int x0, y0, x1, y1;
+    triangle_bounds(v, clip_x0, clip_y0, clip_x1, clip_y1, &x0, &y0, &x1, &y1);
+
+    if (x0 >= x1) return;
+    for (int y = y0; y < y1; y++) {
+        Color *row = target->pixels + (size_t)(y - target->y) * target->stride + (x0 - target->x);
+        fill_span(row, x0, x1, y + 0.5f, edges, v[0].color);
+    }
+}
+
+Image raster_image_alloc(int width, int height, Color color) {
+    return GenImageColor(width, height, color);
+}
+
+void raster_draw_triangles(Image *image, Geometry_Vertex *vertices, size_t count) {
+    noh_assert(image->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 && "Can only rasterize into R8G8B8A8 images.");
+    noh_assert(count % 3 == 0 && "Triangle lists need three vertices per triangle.");
+
+    Fill_Span fill_span = best_fill_span();
+    Raster_Target target = { .pixels = image->data, .stride = image->width };
+    for (size_t i = 0; i + 3 <= count; i += 3) {
+        if (!is_front(&vertices[i])) continue;
+        draw_triangle(&target, &vertices[i], fill_span, 0, 0, image->width, image->height);
+    }
+}
+
+///////////////////////// Scenes /////////////////////////
+
+Raster_Scene raster_scene_init(int width, int height) {
+    Raster_Scene scene = { .width = width, .height = height };
+    scene.tiles_x = (width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    scene.tiles_y = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    scene.bins = noh_realloc_check(NULL, sizeof(Raster_Bin) * scene.tiles_x * scene.tiles_y);
+    memset(scene.bins, 0, sizeof(Raster_Bin) * scene.tiles_x * scene.tiles_y);
+    scene.chunks = noh_pool_init(sizeof(Raster_Chunk));
+    return scene;
+}
+
+// Appends a triangle to a bin, starting a new chunk when the last one is full.
+static void bin_append(Raster_Scene *scene, Raster_Bin *bin, uint triangle) {
+    if (bin->last == NULL || bin->last->count == RASTER_CHUNK_SIZE) {
+        Raster_Chunk *chunk = noh_pool_alloc(&scene->chunks);
+        chunk->next = NULL;
+        chunk->count = 0;
+        if (bin->last == NULL) bin->first = chunk;
+        else bin->last->next = chunk;
+        bin->last = chunk;
+    }
+    bin->last->triangles[bin->last->count++] = triangle;
+}
+
+void raster_scene_add(Raster_Scene *scene, Geometry_Vertex *vertices, size_t count) {
+    noh_assert(count % 3 == 0 && "Triangle lists need three vertices per triangle.");
+
+    for (size_t i = 0; i + 3 <= count; i += 3) {
+        // Back faces never cover anything, so they are dropped before binning.
+        if (!is_front(&vertices[i])) continue;
+
+        int x0, y0, x1, y1;
+        triangle_bounds(&vertices[i], 0, 0, scene->width, scene->height, &x0, &y0, &x1, &y1);
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        uint triangle = (uint)(scene->vertices.count / 3);
+        noh_da_append_multiple(&scene->vertices, &vertices[i], 3);
+
+        // Bin by bounding box, long thin triangles end up in some tiles they don't cover, which only costs a setup.
+        for (int ty = y0 / RASTER_TILE_SIZE; ty <= (y1 - 1) / RASTER_TILE_SIZE; ty++) {
+            for (int tx = x0 / RASTER_TILE_SIZE; tx <= (x1 - 1) / RASTER_TILE_SIZE; tx++) {
+                bin_append(scene, &scene->bins[ty * scene->tiles_x + tx], triangle);
+            }
+        }
+    }
+}
+
+// The state shared by the threads drawing a scene. Threads claim tiles one by one until none are left, so tiles with
+// many triangles don't hold up the other threads.
+typedef struct {
+    Raster_Scene *scene;
+    Image *image;
+    Fill_Span fill_span;
+    atomic_size_t next_tile;
+} Raster_Job;
+
+// Draws a tile into a copy of its pixels, which stays in the cache of the thread while all its triangles are drawn,
+// instead of into rows of the image that are a whole image width apart.
+static void draw_tile(Raster_Job *job, size_t tile, Color *pixels) {
+    Raster_Scene *scene = job->scene;
+    Raster_Bin *bin = &scene->bins[tile];
+    if (bin->first == NULL) return;
+
+    int x0 = (tile % scene->tiles_x) * RASTER_TILE_SIZE;
+    int y0 = (tile / scene->tiles_x) * RASTER_TILE_SIZE;
+    int x1 = min(x0 + RASTER_TILE_SIZE, scene->width);
+    int y1 = min(y0 + RASTER_TILE_SIZE, scene->height);
+
+    Color *image = job->image->data;
+    size_t row_size = sizeof(Color) * (x1 - x0);
+    for (int y = y0; y < y1; y++) {
+        memcpy(pixels + (y - y0) * RASTER_TILE_SIZE, image + (size_t)y * scene->width + x0, row_size);
+    }
+
+    // The bin is in the order triangles were added, so later layers still end up on top.
+    Raster_Target target = { .pixels = pixels, .stride = RASTER_TILE_SIZE, .x = x0, .y = y0 };
+    for (Raster_Chunk *chunk = bin->first; chunk != NULL; chunk = chunk->next) {
+        for (uint i = 0; i < chunk->count; i++) {
+            Geometry_Vertex *triangle = &scene->vertices.elems[3 * chunk->triangles[i]];
+            draw_triangle(&target, triangle, job->fill_span, x0, y0, x1, y1);
+        }
+    }
+
+    for (int y = y0; y < y1; y++) {
+        memcpy(image + (size_t)y * scene->width + x0, pixels + (y - y0) * RASTER_TILE_SIZE, row_size);
+    }
+}
+
+static void raster_worker(Raster_Job *job) {
+    size_t tile_count = (size_t)job->scene->tiles_x * job->scene->tiles_y;
+
+    noh_trace_begin("raster worker");
+    Noh_Scratch scratch = noh_scratch_begin(NULL, 0);
+    Color *pixels = noh_arena_push(scratch.arena, Color, RASTER_TILE_SIZE * RASTER_TILE_SIZE);
+    for (;;) {
+        size_t tile = atomic_fetch_add(&job->next_tile, 1);
+        if (tile >= tile_count) break;
+        draw_tile(job, tile, pixels);
+    }
+    noh_scratch_end(scratch);
+    noh_trace_end("raster worker");
+}
+
+// The extra threads only live for one scene, so their scratch arenas are freed when they are done.
+static void *raster_thread(void *arg) {
+    raster_worker(arg);
+    noh_scratch_free();
+    return NULL;
+}
+
+void raster_scene_draw(Raster_Scene *scene, Image *image, size_t thread_count) {
+    noh_assert(image->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 && "Can only rasterize into R8G8B8A8 images.");
+    noh_assert(image->width == scene->width && image->height == scene->height && "Image does not match the scene.");
+
+    Raster_Job job = { .scene = scene, .image = image, .fill_span = best_fill_span() };
+    atomic_init(&job.next_tile, 0);
+
+    // The calling thread is one of the workers.
+    size_t extra_count = thread_count > 1 ? thread_count - 1 : 0;
+    Noh_Scratch scratch = noh_scratch_begin(NULL, 0);
+    pthread_t *threads = noh_arena_push(scratch.arena, pthread_t, extra_count);
+    size_t started = 0;
+    for (; started < extra_count; started++) {
+        // pthread_create returns its error instead of setting errno.
+        int err = pthread_create(&threads[started], NULL, raster_thread, &job);
+        if (err != 0) {
+            noh_log(NOH_WARNING, "Could not start raster worker: %s, continuing with %zu threads.", strerror(err),
+                started + 1);
+            break;
+        }
+    }
+
+    raster_worker(&job);
+    for (size_t i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    noh_scratch_end(scratch);
+}
+
+size_t raster_scene_triangle_count(Raster_Scene *scene) {
+    return scene->vertices.count / 3;
+}
+
+void raster_scene_reset(Raster_Scene *scene) {
+    noh_da_reset(&scene->vertices);
+    memset(scene->bins, 0, sizeof(Raster_Bin) * scene->tiles_x * scene->tiles_y);
+    noh_pool_reset(&scene->chunks);
+}
+
+void raster_scene_free(Raster_Scene *scene) {
+    noh_da_free(&scene->vertices);
+    noh_pool_free(&scene->chunks);
+    free(scene->bins);
+    scene->bins = NULL;
+}
+
+size_t raster_thread_count() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+}
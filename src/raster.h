@@ -0,0 +1,82 @@
+#ifndef RASTER_H_
+#define RASTER_H_
+
+#include <raylib.h>
+#include "noh.h"
+#include "geometry.h"
+
+// A software rasterizer for layer geometry, for rendering without a GPU or a display. Triangles are culled and filled
+// the same way the GPU does it: back faces are skipped, pixels are covered if their center lies inside a triangle and
+// pixel centers on shared edges are only covered by one of the triangles (the top-left rule).
+
+///////////////////////// Triangles /////////////////////////
+
+// Creates an image that can be rasterized into, filled with the specified color. Unload it with UnloadImage.
+Image raster_image_alloc(int width, int height, Color color);
+
+// Rasterizes a triangle list, every three vertices form a triangle that is filled with the color of its first vertex.
+// The image needs to be in the uncompressed R8G8B8A8 format.
+void raster_draw_triangles(Image *image, Geometry_Vertex *vertices, size_t count);
+
+///////////////////////// Scenes /////////////////////////
+
+// The width and height of a tile in pixels.
+#define RASTER_TILE_SIZE 64
+
+// The number of triangles in a chunk of a bin, which makes a chunk 256 bytes.
+#define RASTER_CHUNK_SIZE 61
+
+// A part of a bin, allocated from the chunk pool of a scene.
+typedef struct Raster_Chunk {
+    struct Raster_Chunk *next;
+    uint count;
+    uint triangles[RASTER_CHUNK_SIZE];
+} Raster_Chunk;
+
+// The triangles overlapping a tile, as indexes into the triangles of a scene, in the order they were added. They are
+// kept in a list of chunks, so bins never need to be copied to grow.
+typedef struct {
+    Raster_Chunk *first;
+    Raster_Chunk *last;
+} Raster_Bin;
+
+typedef struct {
+    Geometry_Vertex *elems;
+    size_t count;
+    size_t capacity;
+} Raster_Vertices;
+
+// Triangles collected from any number of layers and binned per tile of an image, so tiles can be rasterized in
+// parallel. Each tile only sees the triangles in its bin, and draws them in order.
+typedef struct {
+    int width;
+    int height;
+    int tiles_x;
+    int tiles_y;
+    Raster_Vertices vertices; // Only the front facing triangles that are on the image.
+    Raster_Bin *bins; // tiles_x * tiles_y bins, row by row.
+    Noh_Pool chunks; // The chunks of all bins, which are freed together when the scene is reset.
+} Raster_Scene;
+
+// Creates an empty scene for images of the specified size.
+Raster_Scene raster_scene_init(int width, int height);
+
+// Adds a triangle list to a scene, on top of everything added before.
+void raster_scene_add(Raster_Scene *scene, Geometry_Vertex *vertices, size_t count);
+
+// Rasterizes a scene into an image of the same size, using the specified number of threads including the calling one.
+void raster_scene_draw(Raster_Scene *scene, Image *image, size_t thread_count);
+
+// Returns the number of triangles in a scene, after dropping back faces and triangles that are off the image.
+size_t raster_scene_triangle_count(Raster_Scene *scene);
+
+// Removes all triangles from a scene, keeping the memory of the bins to use again.
+void raster_scene_reset(Raster_Scene *scene);
+
+// Frees all memory used by a scene.
+void raster_scene_free(Raster_Scene *scene);
+
+// Returns the number of cpus available to rasterize with.
+size_t raster_thread_count();
+
+#endif // RASTER_H_
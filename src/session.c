@@ -0,0 +1,155 @@
+#include "session.h"
+
+_Static_assert(sizeof(Session_Header) % SESSION_ALIGN == 0, "The layer table must be aligned.");
+_Static_assert(sizeof(Session_Layer) % SESSION_ALIGN == 0, "The layer table must be aligned.");
+_Static_assert(sizeof(Vector2) == 8, "Points are stored as two floats.");
+
+// Rounds a file position up to the alignment of the parts of a session.
+static uint64 session_align(uint64 position) {
+    return (position + SESSION_ALIGN - 1) & ~(uint64)(SESSION_ALIGN - 1);
+}
+
+///////////////////////// Loading /////////////////////////
+
+bool session_load(Session *session, Layers *layers, const char *path) {
+    bool result = true;
+    Noh_File_Map file = {0};
+    if (!noh_file_map(&file, path)) noh_return_defer(false);
+
+    const char *data = file.contents.elems;
+    size_t size = file.contents.count;
+    if (size < sizeof(Session_Header)) {
+        noh_log(NOH_ERROR, "Session %s is too small to be a session.", path);
+        noh_return_defer(false);
+    }
+
+    const Session_Header *header = (const Session_Header *)data;
+    if (memcmp(header->magic, SESSION_MAGIC, sizeof(header->magic)) != 0) {
+        noh_log(NOH_ERROR, "%s is not a session.", path);
+        noh_return_defer(false);
+    }
+    if (header->version != SESSION_VERSION) {
+        noh_log(NOH_ERROR, "Session %s has version %u, only version %u is supported.", path, header->version,
+            SESSION_VERSION);
+        noh_return_defer(false);
+    }
+    if ((size - sizeof(Session_Header)) / sizeof(Session_Layer) < header->layer_count) {
+        noh_log(NOH_ERROR, "Session %s is truncated in the layer table.", path);
+        noh_return_defer(false);
+    }
+
+    // Check every layer before using any, so a broken file doesn't leave half of its layers behind.
+    const Session_Layer *table = (const Session_Layer *)(header + 1);
+    for (uint i = 0; i < header->layer_count; i++) {
+        const Session_Layer *layer = &table[i];
+        if (layer->offset % SESSION_ALIGN != 0 || layer->offset > size
+            || (size - layer->offset) / sizeof(Vector2) < layer->count) {
+            noh_log(NOH_ERROR, "Session %s has invalid points for layer %u.", path, i);
+            noh_return_defer(false);
+        }
+    }
+
+    for (uint i = 0; i < header->layer_count; i++) {
+        Points points = {0};
+        if (table[i].count > 0) {
+            points.elems = (Vector2 *)(data + table[i].offset);
+            points.count = table[i].count;
+            points.capacity = table[i].count;
+            points.mapped = true;
+            points.unindexed = true;
+        }
+        noh_da_append(layers, points);
+    }
+
+    // There is always at least one layer to draw in.
+    if (layers->count == 0) {
+        Points empty = {0};
+        noh_da_append(layers, empty);
+    }
+    layers->active_layer = header->active_layer < layers->count ? header->active_layer : 0;
+    layers->comparison_layer = header->comparison_layer < (int)layers->count ? header->comparison_layer : -1;
+
+    session->file = file;
+    file = (Noh_File_Map) {0};
+
+defer:
+    noh_file_unmap(&file);
+    return result;
+}
+
+void session_unmap(Session *session) {
+    noh_file_unmap(&session->file);
+}
+
+///////////////////////// Saving /////////////////////////
+
+// Writes zeros up to the next aligned position.
+static void write_padding(FILE *f, uint64 position) {
+    static const char zeros[SESSION_ALIGN] = {0};
+    fwrite(zeros, 1, session_align(position) - position, f);
+}
+
+bool session_save(Layers *layers, const char *path) {
+    bool result = true;
+    Vector2 *decoded = NULL;
+    char *temp_path = noh_realloc_check(NULL, strlen(path) + 5);
+    sprintf(temp_path, "%s.tmp", path);
+
+    FILE *f = fopen(temp_path, "wb");
+    if (f == NULL) {
+        noh_log(NOH_ERROR, "Could not open %s: %s.", temp_path, strerror(errno));
+        noh_return_defer(false);
+    }
+
+    Session_Header header = {0};
+    memcpy(header.magic, SESSION_MAGIC, sizeof(header.magic));
+    header.version = SESSION_VERSION;
+    header.layer_count = (uint)layers->count;
+    header.active_layer = (uint)layers->active_layer;
+    header.comparison_layer = layers->comparison_layer;
+    fwrite(&header, sizeof(header), 1, f);
+
+    uint64 position = session_align(sizeof(Session_Header) + layers->count * sizeof(Session_Layer));
+    for (size_t i = 0; i < layers->count; i++) {
+        Session_Layer layer = { .offset = position, .count = layers->elems[i].count };
+        fwrite(&layer, sizeof(layer), 1, f);
+        position = session_align(position + layer.count * sizeof(Vector2));
+    }
+    write_padding(f, sizeof(Session_Header) + layers->count * sizeof(Session_Layer));
+
+    for (size_t i = 0; i < layers->count; i++) {
+        Points *points = &layers->elems[i];
+        const Vector2 *elems = points->elems;
+        if (points->count == 0) continue;
+
+        // Compact layers are decoded one at a time, instead of being expanded in place.
+        if (points->compact) {
+            decoded = noh_realloc_check(decoded, points->count * sizeof(Vector2));
+            quant_decode(&points->quantized, decoded);
+            elems = decoded;
+        }
+
+        fwrite(elems, sizeof(Vector2), points->count, f);
+        write_padding(f, points->count * sizeof(Vector2));
+    }
+
+    if (ferror(f)) {
+        noh_log(NOH_ERROR, "Could not write %s: %s.", temp_path, strerror(errno));
+        noh_return_defer(false);
+    }
+
+    // Replace the session only once it is completely written. A mapping of the old file stays valid.
+    bool closed = fclose(f) == 0;
+    f = NULL;
+    if (!closed || rename(temp_path, path) < 0) {
+        noh_log(NOH_ERROR, "Could not save session %s: %s.", path, strerror(errno));
+        noh_return_defer(false);
+    }
+
+defer:
+    if (f) fclose(f);
+    if (!result) remove(temp_path);
+    free(decoded);
+    free(temp_path);
+    return result;
+}
@@ -0,0 +1,46 @@
+#ifndef SESSION_H_
+#define SESSION_H_
+
+#include "noh.h"
+#include "points.h"
+
+// A binary file holding all layers, which is mapped into memory and used as is, without parsing or copying points.
+// The file starts with a header, followed by a table with an entry per layer, followed by the points of every layer as
+// arrays of Vector2. Every part starts at a multiple of SESSION_ALIGN bytes. Numbers are in the byte order of the
+// machine that wrote the file.
+
+#define SESSION_MAGIC "TRISTRIP"
+#define SESSION_VERSION 1
+#define SESSION_ALIGN 8
+
+typedef struct {
+    char magic[8]; // SESSION_MAGIC, without a terminating zero.
+    uint version;
+    uint layer_count;
+    uint active_layer;
+    int comparison_layer;
+} Session_Header;
+
+typedef struct {
+    uint64 offset; // The position of the points of the layer in the file.
+    uint64 count;
+} Session_Layer;
+
+// A mapped session file. Layers loaded from it point into the mapping, so it has to outlive them.
+typedef struct {
+    Noh_File_Map file;
+} Session;
+
+// Maps a session file and appends its layers to the specified layers, which should be empty. The points of the
+// layers stay in the mapping until they are edited, and their indexes are only built once they are needed.
+// Returns whether the file could be read and is a valid session.
+bool session_load(Session *session, Layers *layers, const char *path);
+
+// Writes all layers to a session file. The file is written next to the path first and then moved over it, so a mapped
+// session can be saved to the file it was loaded from.
+bool session_save(Layers *layers, const char *path);
+
+// Unmaps a session file. Layers loaded from it must be freed first.
+void session_unmap(Session *session);
+
+#endif // SESSION_H_
@@ -0,0 +1,108 @@
+#include "strip.h"
+#include <raymath.h>
+#include <rlgl.h>
+
+// The number of vertices that fit in the default render batch, minus some room for the alignment vertices that rlgl
+// inserts when switching draw modes.
+#define STRIP_BATCH_VERTICES (RL_DEFAULT_BATCH_BUFFER_ELEMENTS * 4 - 8)
+
+// The number of triangles drawn per chunk. Every triangle takes three vertices in the batch. This is kept even, so
+// every chunk starts at an even position in the strip and the winding of its triangles does not flip.
+#define STRIP_CHUNK_TRIANGLES ((STRIP_BATCH_VERTICES / 3) & ~(size_t)1)
+
+// Draws a strip either from points with a single color, or from vertices with their own colors.
+static size_t draw_chunked(Vector2 *points, Geometry_Vertex *vertices, size_t count, Color color) {
+    if (count < 3) return 0;
+
+    size_t flushes = 0;
+    // Consecutive chunks overlap by two vertices, so the triangle spanning the chunk border is drawn exactly once.
+    for (size_t start = 0; start + 2 < count; start += STRIP_CHUNK_TRIANGLES) {
+        size_t end = min(count, start + STRIP_CHUNK_TRIANGLES + 2);
+
+        // Flush before the chunk if it does not fit in what is left of the batch.
+        if (rlCheckRenderBatchLimit(3 * (end - start - 2))) flushes++;
+
+        rlBegin(RL_TRIANGLES);
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        for (size_t i = start + 2; i < end; i++) {
+            // Same vertex order as DrawTriangleStrip, which alternates on the position in the whole strip.
+            size_t order[3] = { i, i - 2, i - 1 };
+            if (i % 2 == 1) {
+                order[1] = i - 1;
+                order[2] = i - 2;
+            }
+            for (int k = 0; k < 3; k++) {
+                if (vertices != NULL) {
+                    Geometry_Vertex v = vertices[order[k]];
+                    rlColor4ub(v.color.r, v.color.g, v.color.b, v.color.a);
+                    rlVertex2f(v.position.x, v.position.y);
+                } else {
+                    rlVertex2f(points[order[k]].x, points[order[k]].y);
+                }
+            }
+        }
+        rlEnd();
+    }
+
+    return flushes;
+}
+
+size_t draw_triangle_strip_chunked(Vector2 *points, size_t count, Color color) {
+    return draw_chunked(points, NULL, count, color);
+}
+
+///////////////////////// Stitching /////////////////////////
+
+// Starts a new strip with its first vertex, joining it to the strips before it.
+static void start_strip(Stitched_Strip *stitched, Geometry_Vertex first) {
+    if (stitched->count > 0) {
+        Geometry_Vertex last = stitched->elems[stitched->count - 1];
+        noh_da_append_with(stitched->allocator, stitched, last);
+        noh_da_append_with(stitched->allocator, stitched, first);
+        if (stitched->count % 2 == 1) noh_da_append_with(stitched->allocator, stitched, first);
+    }
+
+    noh_da_append_with(stitched->allocator, stitched, first);
+}
+
+void stitch_strip(Stitched_Strip *stitched, Vector2 *points, size_t count, Color color) {
+    if (count == 0) return;
+
+    start_strip(stitched, CLITERAL(Geometry_Vertex) { points[0], color });
+    for (size_t i = 1; i < count; i++) {
+        Geometry_Vertex v = { points[i], color };
+        noh_da_append_with(stitched->allocator, stitched, v);
+    }
+}
+
+void stitch_layer(Stitched_Strip *stitched, Vector2 *points, size_t count, float spacing, Vector2 offset,
+    Layer_Colors colors) {
+    // Filled triangle strip, only if it has any triangles.
+    if (count >= 3) {
+        for (size_t i = 0; i < count; i++) {
+            Geometry_Vertex v = { Vector2Add(offset, Vector2Scale(points[i], spacing)), colors.fill };
+            if (i == 0) start_strip(stitched, v);
+            else noh_da_append_with(stitched->allocator, stitched, v);
+        }
+    }
+
+    // Lines between points.
+    for (size_t i = 1; i < count; i++) {
+        Vector2 quad[4];
+        Vector2 a = Vector2Add(offset, Vector2Scale(points[i - 1], spacing));
+        Vector2 b = Vector2Add(offset, Vector2Scale(points[i], spacing));
+        geometry_line_strip(a, b, GEOMETRY_LINE_WIDTH, quad);
+        stitch_strip(stitched, quad, 4, colors.lines);
+    }
+
+    // Point circles.
+    for (size_t i = 0; i < count; i++) {
+        Vector2 circle[GEOMETRY_CIRCLE_SEGMENTS];
+        geometry_circle_strip(Vector2Add(offset, Vector2Scale(points[i], spacing)), circle);
+        stitch_strip(stitched, circle, GEOMETRY_CIRCLE_SEGMENTS, colors.points);
+    }
+}
+
+size_t draw_stitched_strip(Stitched_Strip *stitched) {
+    return draw_chunked(NULL, stitched->elems, stitched->count, BLANK);
+}
@@ -0,0 +1,39 @@
+#ifndef STRIP_H_
+#define STRIP_H_
+
+#include <raylib.h>
+#include "noh.h"
+#include "geometry.h"
+
+// Submitting triangle strips of any length through the rlgl render batch.
+
+// Draws a triangle strip in screen coordinates, like DrawTriangleStrip. The strip is split into chunks that each fit
+// in the render batch, so the batch is only flushed between chunks and never halfway through the strip.
+// Returns the number of batch flushes the strip caused.
+size_t draw_triangle_strip_chunked(Vector2 *points, size_t count, Color color);
+
+///////////////////////// Stitching /////////////////////////
+
+// A single triangle strip with a color per vertex, made of several strips joined by degenerate triangles.
+typedef struct {
+    Geometry_Vertex *elems;
+    size_t count;
+    size_t capacity;
+    Noh_Allocator allocator; // Where the vertices are allocated, the heap if it is zero.
+} Stitched_Strip;
+
+// Appends a strip, joined to the strips before it by repeating the last vertex before it and its own first vertex.
+// The triangles across the join all repeat a vertex and cover nothing. The first vertex is repeated once more when
+// needed to start the strip at an even position, so its triangles keep their winding.
+void stitch_strip(Stitched_Strip *stitched, Vector2 *points, size_t count, Color color);
+
+// Appends everything that is drawn of a layer, with points in grid coordinates: the filled triangle strip, a quad per
+// line and a zigzag strip per point circle. Points are scaled by spacing and moved by offset.
+void stitch_layer(Stitched_Strip *stitched, Vector2 *points, size_t count, float spacing, Vector2 offset,
+    Layer_Colors colors);
+
+// Draws a stitched strip like draw_triangle_strip_chunked, with the color of each triangle taken from its vertices.
+// Returns the number of batch flushes the strip caused.
+size_t draw_stitched_strip(Stitched_Strip *stitched);
+
+#endif // STRIP_H_
@@ -0,0 +1,327 @@
+#include "stripify.h"
+
+///////////////////////// Edge table /////////////////////////
+
+// A directed edge of a triangle, stored in a chained hash table. Every triangle has three of these, so the triangle
+// on the other side of an edge u->v is found by looking up v->u.
+typedef struct {
+    uint64 key; // (u << 32) | v
+    uint triangle;
+    uint next; // The next entry in the same bucket, or EDGE_NONE.
+} Edge_Entry;
+
+#define EDGE_NONE ((uint)-1)
+
+typedef struct {
+    uint *buckets; // Always a power of two.
+    size_t mask;
+    Edge_Entry *entries;
+    size_t entry_count;
+} Edge_Table;
+
+static uint64 edge_key(uint u, uint v) {
+    return (uint64)u << 32 | v;
+}
+
+static size_t hash_edge(uint64 key) {
+    key *= 0x9E3779B97F4A7C15ul;
+    return (size_t)(key ^ key >> 32);
+}
+
+static Edge_Table edge_table_init(size_t entry_count) {
+    Edge_Table table = {0};
+    size_t bucket_count = 1;
+    while (bucket_count < entry_count * 2) bucket_count *= 2;
+    table.buckets = noh_realloc_check(NULL, bucket_count * sizeof(uint));
+    memset(table.buckets, 0xFF, bucket_count * sizeof(uint));
+    table.mask = bucket_count - 1;
+    table.entries = noh_realloc_check(NULL, (entry_count > 0 ? entry_count : 1) * sizeof(Edge_Entry));
+    return table;
+}
+
+static void edge_table_add(Edge_Table *table, uint u, uint v, uint triangle) {
+    uint64 key = edge_key(u, v);
+    size_t bucket = hash_edge(key) & table->mask;
+    table->entries[table->entry_count] = (Edge_Entry) { key, triangle, table->buckets[bucket] };
+    table->buckets[bucket] = (uint)table->entry_count++;
+}
+
+static void edge_table_free(Edge_Table *table) {
+    free(table->buckets);
+    free(table->entries);
+}
+
+///////////////////////// Stripifier /////////////////////////
+
+typedef struct {
+    uint *elems;
+    size_t count;
+    size_t capacity;
+} Triangle_Stack;
+
+typedef struct {
+    const uint *indices;
+    size_t triangle_count;
+
+    // For edge k of triangle t, from vertex k to vertex k + 1, neighbours[3 * t + k] is the triangle on the other side,
+    // which has the same edge in the opposite direction, or EDGE_NONE. Where more than two triangles share an edge,
+    // only one of them is linked.
+    uint *neighbours;
+
+    bool *used;
+    uint *visited; // The trial a triangle was last taken by, so trials don't need to clear anything.
+    uint trial;
+
+    // Remaining triangles by their number of remaining neighbours. Entries go stale when a neighbour is taken, these
+    // are skipped when popped.
+    uint8 *degree;
+    Triangle_Stack by_degree[4];
+
+    // With a triangle order, the position of every triangle in it. Strips only take triangles up to the limit.
+    uint *rank;
+    size_t rank_limit;
+} Stripifier;
+
+static bool is_free(Stripifier *s, uint triangle) {
+    if (triangle == EDGE_NONE || s->used[triangle] || s->visited[triangle] == s->trial) return false;
+    return s->rank == NULL || s->rank[triangle] < s->rank_limit;
+}
+
+// Links every triangle to its neighbours, through a table of all directed edges.
+static void link_neighbours(Stripifier *s) {
+    Edge_Table edges = edge_table_init(3 * s->triangle_count);
+    for (uint t = 0; t < s->triangle_count; t++) {
+        if (s->used[t]) continue;
+        const uint *v = &s->indices[3 * t];
+        for (int k = 0; k < 3; k++) edge_table_add(&edges, v[k], v[(k + 1) % 3], t);
+    }
+
+    for (uint t = 0; t < s->triangle_count; t++) {
+        const uint *v = &s->indices[3 * t];
+        for (int k = 0; k < 3; k++) {
+            uint *neighbour = &s->neighbours[3 * t + k];
+            *neighbour = EDGE_NONE;
+            if (s->used[t]) continue;
+
+            uint64 key = edge_key(v[(k + 1) % 3], v[k]);
+            for (uint e = edges.buckets[hash_edge(key) & edges.mask]; e != EDGE_NONE; e = edges.entries[e].next) {
+                if (edges.entries[e].key == key && edges.entries[e].triangle != t) {
+                    *neighbour = edges.entries[e].triangle;
+                    break;
+                }
+            }
+        }
+    }
+
+    edge_table_free(&edges);
+}
+
+// Returns the index of the edge of a triangle between vertices u and v, in either direction.
+static int find_edge(Stripifier *s, uint triangle, uint u, uint v) {
+    const uint *t = &s->indices[3 * triangle];
+    for (int k = 0; k < 3; k++) {
+        uint a = t[k], b = t[(k + 1) % 3];
+        if ((a == u && b == v) || (a == v && b == u)) return k;
+    }
+    noh_assert(false && "Triangle does not contain the edge.");
+    return -1;
+}
+
+static void take_triangle(Stripifier *s, uint triangle) {
+    s->used[triangle] = true;
+
+    // The neighbours lose a neighbour, move them to the lower degree.
+    for (int k = 0; k < 3; k++) {
+        uint neighbour = s->neighbours[3 * triangle + k];
+        if (neighbour == EDGE_NONE || s->used[neighbour] || s->degree[neighbour] == 0) continue;
+        s->degree[neighbour]--;
+        noh_da_append(&s->by_degree[s->degree[neighbour]], neighbour);
+    }
+}
+
+// Grows a strip starting with the triangle (a, b, c). When appending to an output, the triangles are taken, otherwise
+// they are only visited for the current trial. Returns the number of triangles in the strip.
+static size_t grow_strip(Stripifier *s, uint triangle, uint a, uint b, uint c, Strip_Indices *out) {
+    uint x = b, y = c;
+    size_t length = 1;
+    if (out) {
+        take_triangle(s, triangle);
+        noh_da_append(out, a);
+        noh_da_append(out, b);
+        noh_da_append(out, c);
+    } else {
+        s->visited[triangle] = s->trial;
+    }
+
+    // The k-th triangle of a strip is wound (w, x, y) for even k and (w, y, x) for odd k, where x and y are the last
+    // two vertices of the strip. The next triangle needs the same edge in the other direction, so it is always the
+    // neighbour across the edge between x and y.
+    for (;;) {
+        uint next = s->neighbours[3 * triangle + find_edge(s, triangle, x, y)];
+        if (!is_free(s, next)) break;
+
+        // The strip continues with the vertex of the next triangle that is not on the shared edge.
+        int k = find_edge(s, next, x, y);
+        uint z = s->indices[3 * next + (k + 2) % 3];
+
+        if (out) {
+            take_triangle(s, next);
+            noh_da_append(out, z);
+        } else {
+            s->visited[next] = s->trial;
+        }
+        triangle = next;
+        x = y;
+        y = z;
+        length++;
+    }
+
+    return length;
+}
+
+// Starts a strip at the specified triangle, trying all three rotations and keeping the longest strip.
+static void emit_strip(Stripifier *s, Strips *strips, uint triangle) {
+    const uint *t = &s->indices[3 * triangle];
+    int best_rotation = 0;
+    size_t best_length = 0;
+    for (int r = 0; r < 3; r++) {
+        s->trial++;
+        size_t length = grow_strip(s, triangle, t[r], t[(r + 1) % 3], t[(r + 2) % 3], NULL);
+        if (length > best_length) {
+            best_length = length;
+            best_rotation = r;
+        }
+    }
+
+    s->trial++;
+    noh_da_append(&strips->starts, strips->indices.count);
+    int r = best_rotation;
+    strips->triangle_count += grow_strip(s, triangle, t[r], t[(r + 1) % 3], t[(r + 2) % 3], &strips->indices);
+}
+
+// Pops the remaining triangle with the fewest remaining neighbours, or returns EDGE_NONE if all are used.
+static uint pop_lowest_degree(Stripifier *s) {
+    for (int d = 0; d < 4; d++) {
+        Triangle_Stack *stack = &s->by_degree[d];
+        while (stack->count > 0) {
+            uint triangle = stack->elems[--stack->count];
+            if (!s->used[triangle] && s->degree[triangle] == d) return triangle;
+        }
+    }
+    return EDGE_NONE;
+}
+
+bool stripify(Strips *strips, const uint *indices, size_t index_count, size_t vertex_count, const uint *order,
+    size_t window) {
+    noh_assert(index_count % 3 == 0 && "Triangle lists need three indices per triangle.");
+    for (size_t i = 0; i < index_count; i++) {
+        if (indices[i] >= vertex_count) {
+            noh_log(NOH_ERROR, "Index %u of triangle %zu is out of range, there are %zu vertices.", indices[i], i / 3,
+                vertex_count);
+            return false;
+        }
+    }
+
+    Stripifier s = { .indices = indices, .triangle_count = index_count / 3, .trial = 1 };
+    s.neighbours = noh_realloc_check(NULL, (index_count + 1) * sizeof(uint));
+    s.used = noh_realloc_check(NULL, s.triangle_count + 1);
+    s.visited = noh_realloc_check(NULL, (s.triangle_count + 1) * sizeof(uint));
+    s.degree = noh_realloc_check(NULL, s.triangle_count + 1);
+    memset(s.visited, 0, s.triangle_count * sizeof(uint));
+
+    // Degenerate triangles can't be part of a strip, mark them as used right away.
+    for (uint t = 0; t < s.triangle_count; t++) {
+        const uint *v = &indices[3 * t];
+        s.used[t] = v[0] == v[1] || v[1] == v[2] || v[2] == v[0];
+    }
+    link_neighbours(&s);
+
+    if (order == NULL) {
+        for (uint t = 0; t < s.triangle_count; t++) {
+            if (s.used[t]) continue;
+            s.degree[t] = 0;
+            for (int k = 0; k < 3; k++) s.degree[t] += s.neighbours[3 * t + k] != EDGE_NONE;
+            noh_da_append(&s.by_degree[s.degree[t]], t);
+        }
+
+        for (uint t = pop_lowest_degree(&s); t != EDGE_NONE; t = pop_lowest_degree(&s)) emit_strip(&s, strips, t);
+    } else {
+        memset(s.degree, 0, s.triangle_count);
+        if (window > 0) {
+            s.rank = noh_realloc_check(NULL, (s.triangle_count + 1) * sizeof(uint));
+            for (size_t i = 0; i < s.triangle_count; i++) s.rank[order[i]] = (uint)i;
+        }
+
+        for (size_t i = 0; i < s.triangle_count; i++) {
+            if (s.used[order[i]]) continue;
+            s.rank_limit = i + window;
+            emit_strip(&s, strips, order[i]);
+        }
+    }
+
+    free(s.neighbours);
+    free(s.used);
+    free(s.visited);
+    free(s.degree);
+    free(s.rank);
+    for (int d = 0; d < 4; d++) noh_da_free(&s.by_degree[d]);
+    return true;
+}
+
+///////////////////////// Strips /////////////////////////
+
+size_t strips_length(Strips *strips, size_t strip) {
+    noh_assert(strip < strips->starts.count && "Strip out of bounds.");
+    size_t end = strip + 1 < strips->starts.count ? strips->starts.elems[strip + 1] : strips->indices.count;
+    return end - strips->starts.elems[strip];
+}
+
+void strips_stitch(Strips *strips, Strip_Indices *out) {
+    for (size_t i = 0; i < strips->starts.count; i++) {
+        const uint *strip = &strips->indices.elems[strips->starts.elems[i]];
+        size_t length = strips_length(strips, i);
+
+        if (out->count > 0) {
+            uint last = out->elems[out->count - 1];
+            noh_da_append(out, last);
+            noh_da_append(out, strip[0]);
+            if (out->count % 2 == 1) noh_da_append(out, strip[0]);
+        }
+        noh_da_append_multiple(out, strip, length);
+    }
+}
+
+size_t strip_to_triangles(const uint *strip, size_t count, uint *out) {
+    size_t triangles = 0;
+    for (size_t k = 0; k + 2 < count; k++) {
+        uint a = strip[k], b = strip[k + 1], c = strip[k + 2];
+        if (a == b || b == c || c == a) continue;
+
+        uint *t = &out[3 * triangles++];
+        t[0] = a;
+        t[1] = k % 2 == 0 ? b : c;
+        t[2] = k % 2 == 0 ? c : b;
+    }
+    return triangles;
+}
+
+Points strip_to_layer(const uint *strip, size_t count, const Vector2 *positions) {
+    // Strips can pass the same vertex more than once, so the points are not added one by one, which would skip the
+    // repeats. The index keeps the first occurrence.
+    Points points = {0};
+    for (size_t i = 0; i < count; i++) noh_da_append(&points, positions[strip[i]]);
+    points_rebuild_index(&points);
+    return points;
+}
+
+void strips_log_stats(Strips *strips) {
+    double per_triangle = strips->triangle_count > 0 ? (double)strips->indices.count / strips->triangle_count : 0;
+    noh_log(NOH_INFO, "Stripified %zu triangles into %zu strips, %.3f vertices per triangle.",
+        strips->triangle_count, strips->starts.count, per_triangle);
+}
+
+void strips_free(Strips *strips) {
+    noh_da_free(&strips->indices);
+    noh_da_free(&strips->starts);
+    strips->triangle_count = 0;
+}
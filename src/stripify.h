@@ -0,0 +1,59 @@
+#ifndef STRIPIFY_H_
+#define STRIPIFY_H_
+
+#include <raylib.h>
+#include "noh.h"
+#include "points.h"
+
+// Turns indexed triangle lists into triangle strips. Strips follow the winding of DrawTriangleStrip: the k-th triangle
+// of a strip is (s[k], s[k+1], s[k+2]) for even k and (s[k], s[k+2], s[k+1]) for odd k, so every triangle keeps the
+// winding it had in the list and backface culling hides the same triangles.
+
+typedef struct {
+    uint *elems;
+    size_t count;
+    size_t capacity;
+} Strip_Indices;
+
+typedef struct {
+    size_t *elems;
+    size_t count;
+    size_t capacity;
+} Strip_Starts;
+
+// A set of strips, stored one after another.
+typedef struct {
+    Strip_Indices indices;
+    Strip_Starts starts; // The first index of each strip.
+    size_t triangle_count; // The number of triangles in all strips.
+} Strips;
+
+// Stripifies an indexed triangle list with index_count / 3 triangles over vertex_count vertices, appending the strips.
+// Strips are grown greedily: a strip starts at the remaining triangle with the fewest remaining neighbours, is grown
+// from each of its three edges and the longest is kept. If an order is specified, strips start at the first remaining
+// triangle in that order instead, and if window is not 0, strips only take the triangles within window positions of
+// it. This keeps strips short and in order, so they keep the vertex reuse of an order optimized for the vertex cache.
+// Triangles repeating a vertex are dropped. Returns false if the indices are out of range.
+bool stripify(Strips *strips, const uint *indices, size_t index_count, size_t vertex_count, const uint *order,
+    size_t window);
+
+// Returns the number of indices in the specified strip.
+size_t strips_length(Strips *strips, size_t strip);
+
+// Appends all strips to a single strip, joined by degenerate triangles like stitch_strip does.
+void strips_stitch(Strips *strips, Strip_Indices *out);
+
+// Writes the triangles of a strip as a triangle list, in the winding they are drawn with. Triangles that repeat an
+// index are skipped. The output needs room for 3 * (count - 2) indexes. Returns the number of triangles written.
+size_t strip_to_triangles(const uint *strip, size_t count, uint *out);
+
+// Returns a layer with the positions of the vertices of a strip, such as the one made by strips_stitch.
+Points strip_to_layer(const uint *strip, size_t count, const Vector2 *positions);
+
+// Logs the number of strips and the average number of strip vertices per triangle.
+void strips_log_stats(Strips *strips);
+
+// Frees all memory used by the strips.
+void strips_free(Strips *strips);
+
+#endif // STRIPIFY_H_
@@ -0,0 +1,255 @@
+#include "transform.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TRANSFORM_X86
+#include <immintrin.h>
+#endif // __x86_64__ || __i386__
+
+///////////////////////// Scalar /////////////////////////
+
+static void scale_offset_scalar(Vector2 *dst, const Vector2 *src, size_t count, float scale, Vector2 offset) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i].x = offset.x + src[i].x * scale;
+        dst[i].y = offset.y + src[i].y * scale;
+    }
+}
+
+static void lerp_scalar(Vector2 *dst, const Vector2 *from, const Vector2 *to, size_t count, float factor) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i].x = from[i].x + (to[i].x - from[i].x) * factor;
+        dst[i].y = from[i].y + (to[i].y - from[i].y) * factor;
+    }
+}
+
+#ifdef TRANSFORM_X86
+
+// The SIMD kernels first transform single vectors until the output is aligned to a register, then use aligned stores.
+// If the inputs are aligned at that point too, which is the case when all arrays are pushed to an arena or allocated
+// on the heap, the loads are aligned as well.
+//
+// Outputs larger than the cache are written with non-temporal stores. These skip reading the destination into the
+// cache before overwriting it, which otherwise adds a third of the memory traffic of a lerp and half of a scale.
+
+#define TRANSFORM_STREAM_BYTES ((size_t)8 MB)
+
+static bool should_stream(size_t count) {
+    return count * sizeof(Vector2) >= TRANSFORM_STREAM_BYTES;
+}
+
+// Returns the number of vectors before dst is aligned to the specified number of bytes, or 0 if it never will be.
+static size_t peel_count(const Vector2 *dst, size_t count, size_t align) {
+    uintptr_t misalignment = (uintptr_t)dst % align;
+    if (misalignment % sizeof(Vector2) != 0) return 0;
+    return min(count, (align - misalignment) % align / sizeof(Vector2));
+}
+
+static bool is_aligned(const void *p, size_t align) {
+    return (uintptr_t)p % align == 0;
+}
+
+///////////////////////// SSE /////////////////////////
+
+// Two vectors per register.
+__attribute__((target("sse2")))
+static void scale_offset_sse(Vector2 *dst, const Vector2 *src, size_t count, float scale, Vector2 offset) {
+    size_t i = peel_count(dst, count, 16);
+    scale_offset_scalar(dst, src, i, scale, offset);
+
+    const float *in = (const float *)src;
+    float *out = (float *)dst;
+    __m128 s = _mm_set1_ps(scale);
+    __m128 o = _mm_setr_ps(offset.x, offset.y, offset.x, offset.y);
+
+    if (is_aligned(out + 2*i, 16) && is_aligned(in + 2*i, 16) && should_stream(count)) {
+        for (; i + 4 <= count; i += 4) {
+            __m128 a = _mm_load_ps(in + 2*i);
+            __m128 b = _mm_load_ps(in + 2*i + 4);
+            _mm_stream_ps(out + 2*i, _mm_add_ps(o, _mm_mul_ps(a, s)));
+            _mm_stream_ps(out + 2*i + 4, _mm_add_ps(o, _mm_mul_ps(b, s)));
+        }
+        _mm_sfence();
+    } else if (is_aligned(out + 2*i, 16) && is_aligned(in + 2*i, 16)) {
+        for (; i + 4 <= count; i += 4) {
+            __m128 a = _mm_load_ps(in + 2*i);
+            __m128 b = _mm_load_ps(in + 2*i + 4);
+            _mm_store_ps(out + 2*i, _mm_add_ps(o, _mm_mul_ps(a, s)));
+            _mm_store_ps(out + 2*i + 4, _mm_add_ps(o, _mm_mul_ps(b, s)));
+        }
+    } else {
+        for (; i + 4 <= count; i += 4) {
+            __m128 a = _mm_loadu_ps(in + 2*i);
+            __m128 b = _mm_loadu_ps(in + 2*i + 4);
+            _mm_storeu_ps(out + 2*i, _mm_add_ps(o, _mm_mul_ps(a, s)));
+            _mm_storeu_ps(out + 2*i + 4, _mm_add_ps(o, _mm_mul_ps(b, s)));
+        }
+    }
+
+    scale_offset_scalar(dst + i, src + i, count - i, scale, offset);
+}
+
+__attribute__((target("sse2")))
+static void lerp_sse(Vector2 *dst, const Vector2 *from, const Vector2 *to, size_t count, float factor) {
+    size_t i = peel_count(dst, count, 16);
+    lerp_scalar(dst, from, to, i, factor);
+
+    const float *a = (const float *)from;
+    const float *b = (const float *)to;
+    float *out = (float *)dst;
+    __m128 f = _mm_set1_ps(factor);
+
+    if (is_aligned(out + 2*i, 16) && is_aligned(a + 2*i, 16) && is_aligned(b + 2*i, 16) && should_stream(count)) {
+        for (; i + 2 <= count; i += 2) {
+            __m128 va = _mm_load_ps(a + 2*i);
+            __m128 vb = _mm_load_ps(b + 2*i);
+            _mm_stream_ps(out + 2*i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), f)));
+        }
+        _mm_sfence();
+    } else if (is_aligned(out + 2*i, 16) && is_aligned(a + 2*i, 16) && is_aligned(b + 2*i, 16)) {
+        for (; i + 2 <= count; i += 2) {
+            __m128 va = _mm_load_ps(a + 2*i);
+            __m128 vb = _mm_load_ps(b + 2*i);
+            _mm_store_ps(out + 2*i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), f)));
+        }
+    } else {
+        for (; i + 2 <= count; i += 2) {
+            __m128 va = _mm_loadu_ps(a + 2*i);
+            __m128 vb = _mm_loadu_ps(b + 2*i);
+            _mm_storeu_ps(out + 2*i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), f)));
+        }
+    }
+
+    lerp_scalar(dst + i, from + i, to + i, count - i, factor);
+}
+
+///////////////////////// AVX2 /////////////////////////
+
+// Four vectors per register, two registers per iteration.
+__attribute__((target("avx2")))
+static void scale_offset_avx2(Vector2 *dst, const Vector2 *src, size_t count, float scale, Vector2 offset) {
+    size_t i = peel_count(dst, count, 32);
+    scale_offset_scalar(dst, src, i, scale, offset);
+
+    const float *in = (const float *)src;
+    float *out = (float *)dst;
+    __m256 s = _mm256_set1_ps(scale);
+    __m256 o = _mm256_setr_ps(offset.x, offset.y, offset.x, offset.y, offset.x, offset.y, offset.x, offset.y);
+
+    if (is_aligned(out + 2*i, 32) && is_aligned(in + 2*i, 32) && should_stream(count)) {
+        for (; i + 8 <= count; i += 8) {
+            __m256 a = _mm256_load_ps(in + 2*i);
+            __m256 b = _mm256_load_ps(in + 2*i + 8);
+            _mm256_stream_ps(out + 2*i, _mm256_add_ps(o, _mm256_mul_ps(a, s)));
+            _mm256_stream_ps(out + 2*i + 8, _mm256_add_ps(o, _mm256_mul_ps(b, s)));
+        }
+        _mm_sfence();
+    } else if (is_aligned(out + 2*i, 32) && is_aligned(in + 2*i, 32)) {
+        for (; i + 8 <= count; i += 8) {
+            __m256 a = _mm256_load_ps(in + 2*i);
+            __m256 b = _mm256_load_ps(in + 2*i + 8);
+            _mm256_store_ps(out + 2*i, _mm256_add_ps(o, _mm256_mul_ps(a, s)));
+            _mm256_store_ps(out + 2*i + 8, _mm256_add_ps(o, _mm256_mul_ps(b, s)));
+        }
+    } else {
+        for (; i + 8 <= count; i += 8) {
+            __m256 a = _mm256_loadu_ps(in + 2*i);
+            __m256 b = _mm256_loadu_ps(in + 2*i + 8);
+            _mm256_storeu_ps(out + 2*i, _mm256_add_ps(o, _mm256_mul_ps(a, s)));
+            _mm256_storeu_ps(out + 2*i + 8, _mm256_add_ps(o, _mm256_mul_ps(b, s)));
+        }
+    }
+
+    scale_offset_sse(dst + i, src + i, count - i, scale, offset);
+}
+
+__attribute__((target("avx2")))
+static void lerp_avx2(Vector2 *dst, const Vector2 *from, const Vector2 *to, size_t count, float factor) {
+    size_t i = peel_count(dst, count, 32);
+    lerp_scalar(dst, from, to, i, factor);
+
+    const float *a = (const float *)from;
+    const float *b = (const float *)to;
+    float *out = (float *)dst;
+    __m256 f = _mm256_set1_ps(factor);
+
+    if (is_aligned(out + 2*i, 32) && is_aligned(a + 2*i, 32) && is_aligned(b + 2*i, 32) && should_stream(count)) {
+        for (; i + 4 <= count; i += 4) {
+            __m256 va = _mm256_load_ps(a + 2*i);
+            __m256 vb = _mm256_load_ps(b + 2*i);
+            _mm256_stream_ps(out + 2*i, _mm256_add_ps(va, _mm256_mul_ps(_mm256_sub_ps(vb, va), f)));
+        }
+        _mm_sfence();
+    } else if (is_aligned(out + 2*i, 32) && is_aligned(a + 2*i, 32) && is_aligned(b + 2*i, 32)) {
+        for (; i + 4 <= count; i += 4) {
+            __m256 va = _mm256_load_ps(a + 2*i);
+            __m256 vb = _mm256_load_ps(b + 2*i);
+            _mm256_store_ps(out + 2*i, _mm256_add_ps(va, _mm256_mul_ps(_mm256_sub_ps(vb, va), f)));
+        }
+    } else {
+        for (; i + 4 <= count; i += 4) {
+            __m256 va = _mm256_loadu_ps(a + 2*i);
+            __m256 vb = _mm256_loadu_ps(b + 2*i);
+            _mm256_storeu_ps(out + 2*i, _mm256_add_ps(va, _mm256_mul_ps(_mm256_sub_ps(vb, va), f)));
+        }
+    }
+
+    lerp_sse(dst + i, from + i, to + i, count - i, factor);
+}
+
+#endif // TRANSFORM_X86
+
+///////////////////////// Dispatch /////////////////////////
+
+Transform_Kernel transform_best_kernel() {
+#ifdef TRANSFORM_X86
+    static int best = -1;
+    if (best < 0) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) best = TRANSFORM_AVX2;
+        else if (__builtin_cpu_supports("sse2")) best = TRANSFORM_SSE;
+        else best = TRANSFORM_SCALAR;
+    }
+    return (Transform_Kernel)best;
+#else
+    return TRANSFORM_SCALAR;
+#endif // TRANSFORM_X86
+}
+
+const char *transform_kernel_name(Transform_Kernel kernel) {
+    switch (kernel) {
+        case TRANSFORM_SCALAR: return "scalar";
+        case TRANSFORM_SSE: return "sse";
+        case TRANSFORM_AVX2: return "avx2";
+        default: noh_assert(false && "Invalid transform kernel");
+    }
+    return NULL;
+}
+
+void transform_scale_offset_with(Transform_Kernel kernel, Vector2 *dst, const Vector2 *src, size_t count,
+    float scale, Vector2 offset) {
+    switch (kernel) {
+#ifdef TRANSFORM_X86
+        case TRANSFORM_AVX2: scale_offset_avx2(dst, src, count, scale, offset); break;
+        case TRANSFORM_SSE: scale_offset_sse(dst, src, count, scale, offset); break;
+#endif // TRANSFORM_X86
+        default: scale_offset_scalar(dst, src, count, scale, offset); break;
+    }
+}
+
+void transform_lerp_with(Transform_Kernel kernel, Vector2 *dst, const Vector2 *from, const Vector2 *to, size_t count,
+    float factor) {
+    switch (kernel) {
+#ifdef TRANSFORM_X86
+        case TRANSFORM_AVX2: lerp_avx2(dst, from, to, count, factor); break;
+        case TRANSFORM_SSE: lerp_sse(dst, from, to, count, factor); break;
+#endif // TRANSFORM_X86
+        default: lerp_scalar(dst, from, to, count, factor); break;
+    }
+}
+
+void transform_scale_offset(Vector2 *dst, const Vector2 *src, size_t count, float scale, Vector2 offset) {
+    transform_scale_offset_with(transform_best_kernel(), dst, src, count, scale, offset);
+}
+
+void transform_lerp(Vector2 *dst, const Vector2 *from, const Vector2 *to, size_t count, float factor) {
+    transform_lerp_with(transform_best_kernel(), dst, from, to, count, factor);
+}
@@ -0,0 +1,41 @@
+#ifndef TRANSFORM_H_
+#define TRANSFORM_H_
+
+#include <raylib.h>
+#include "noh.h"
+
+// Bulk transforms of Vector2 arrays, used to convert whole layers at once. The interleaved x/y layout of Vector2 is
+// kept, since the mesh, strip and raster code read whole vertices, and splitting x and y would not reduce the bytes
+// moved by these memory bound loops. Every lane gets the same scale and the offset alternates between the x and y
+// component, so the arrays can be processed as flat float arrays. Arrays that are aligned to 32 bytes, like those
+// pushed to an arena, are processed with aligned loads and stores only, and large outputs bypass the cache.
+
+// The implementations of the kernels, so they can be compared against each other.
+typedef enum {
+    TRANSFORM_SCALAR,
+    TRANSFORM_SSE,
+    TRANSFORM_AVX2,
+} Transform_Kernel;
+
+// Returns the best kernel supported by the cpu running the program.
+Transform_Kernel transform_best_kernel();
+
+// Returns a readable name of a kernel.
+const char *transform_kernel_name(Transform_Kernel kernel);
+
+// Computes dst[i] = offset + src[i] * scale for count vectors, using the specified kernel.
+// dst and src may be the same array.
+void transform_scale_offset_with(Transform_Kernel kernel, Vector2 *dst, const Vector2 *src, size_t count,
+    float scale, Vector2 offset);
+
+// Computes dst[i] = from[i] + (to[i] - from[i]) * factor for count vectors, using the specified kernel.
+void transform_lerp_with(Transform_Kernel kernel, Vector2 *dst, const Vector2 *from, const Vector2 *to, size_t count,
+    float factor);
+
+// Computes dst[i] = offset + src[i] * scale for count vectors, using the best available kernel.
+void transform_scale_offset(Vector2 *dst, const Vector2 *src, size_t count, float scale, Vector2 offset);
+
+// Computes dst[i] = from[i] + (to[i] - from[i]) * factor for count vectors, using the best available kernel.
+void transform_lerp(Vector2 *dst, const Vector2 *from, const Vector2 *to, size_t count, float factor);
+
+#endif // TRANSFORM_H_
@@ -0,0 +1,156 @@
+#include "vcache.h"
+
+///////////////////////// Simulation /////////////////////////
+
+const char *vcache_policy_name(Vcache_Policy policy) {
+    switch (policy) {
+        case VCACHE_FIFO: return "FIFO";
+        case VCACHE_LRU: return "LRU";
+        default: noh_assert(false && "Invalid vertex cache policy.");
+    }
+    return NULL;
+}
+
+// Looks up an index in the simulated cache, inserting it on a miss. The cache is kept in order from the newest entry
+// to the oldest one. Cache sizes are a few dozen entries at most, so a linear search is the fastest there is.
+static bool cache_lookup(uint *cache, size_t *count, size_t size, uint index, Vcache_Policy policy) {
+    for (size_t i = 0; i < *count; i++) {
+        if (cache[i] != index) continue;
+        if (policy == VCACHE_LRU) {
+            memmove(cache + 1, cache, i * sizeof(uint));
+            cache[0] = index;
+        }
+        return true;
+    }
+
+    if (*count < size) (*count)++;
+    memmove(cache + 1, cache, (*count - 1) * sizeof(uint));
+    cache[0] = index;
+    return false;
+}
+
+double vcache_acmr(const uint *indices, size_t index_count, bool strip, Vcache_Policy policy, size_t cache_size) {
+    noh_assert(cache_size > 0 && "The vertex cache needs room for at least one vertex.");
+    noh_assert((strip || index_count % 3 == 0) && "Triangle lists need three indices per triangle.");
+
+    uint *cache = noh_realloc_check(NULL, cache_size * sizeof(uint));
+    size_t count = 0;
+    size_t misses = 0;
+    for (size_t i = 0; i < index_count; i++) {
+        if (!cache_lookup(cache, &count, cache_size, indices[i], policy)) misses++;
+    }
+    free(cache);
+
+    size_t triangles = 0;
+    if (!strip) {
+        triangles = index_count / 3;
+    } else {
+        for (size_t i = 2; i < index_count; i++) {
+            uint a = indices[i - 2], b = indices[i - 1], c = indices[i];
+            triangles += a != b && b != c && c != a;
+        }
+    }
+
+    return triangles > 0 ? (double)misses / triangles : 0;
+}
+
+///////////////////////// Tipsify /////////////////////////
+
+typedef struct {
+    uint *elems;
+    size_t count;
+    size_t capacity;
+} Vertex_Stack;
+
+// Picks the next vertex to fan around from the candidates: the one with triangles left that stays longest in the
+// cache, as long as its triangles can be emitted before it is evicted. Returns -1 if there is none.
+static long next_candidate(uint *candidates, size_t candidate_count, uint *live, size_t *timestamps, size_t time,
+    size_t cache_size) {
+    long best = -1;
+    size_t best_priority = 0;
+    for (size_t i = 0; i < candidate_count; i++) {
+        uint v = candidates[i];
+        if (live[v] == 0) continue;
+
+        size_t priority = 0;
+        if (time - timestamps[v] + 2 * live[v] <= cache_size) priority = time - timestamps[v];
+        if (best == -1 || priority > best_priority) {
+            best = v;
+            best_priority = priority;
+        }
+    }
+    return best;
+}
+
+// Finds a vertex to continue with when the last fan left no candidates: the most recent vertex with triangles left,
+// or else the next vertex in input order. Returns -1 if all triangles are emitted.
+static long skip_dead_end(Vertex_Stack *dead_ends, uint *live, size_t vertex_count, size_t *cursor) {
+    while (dead_ends->count > 0) {
+        uint v = dead_ends->elems[--dead_ends->count];
+        if (live[v] > 0) return v;
+    }
+    for (; *cursor < vertex_count; (*cursor)++) {
+        if (live[*cursor] > 0) return (long)*cursor;
+    }
+    return -1;
+}
+
+void vcache_tipsify(const uint *indices, size_t index_count, size_t vertex_count, size_t cache_size, uint *order) {
+    noh_assert(index_count % 3 == 0 && "Triangle lists need three indices per triangle.");
+    size_t triangle_count = index_count / 3;
+
+    // The triangles around every vertex, as ranges in one array.
+    uint *live = noh_realloc_check(NULL, (vertex_count + 1) * sizeof(uint));
+    size_t *offsets = noh_realloc_check(NULL, (vertex_count + 1) * sizeof(size_t));
+    uint *adjacency = noh_realloc_check(NULL, (index_count + 1) * sizeof(uint));
+    memset(live, 0, vertex_count * sizeof(uint));
+    for (size_t i = 0; i < index_count; i++) live[indices[i]]++;
+    offsets[0] = 0;
+    for (size_t v = 0; v < vertex_count; v++) offsets[v + 1] = offsets[v] + live[v];
+    size_t *fill = noh_realloc_check(NULL, (vertex_count + 1) * sizeof(size_t));
+    memcpy(fill, offsets, vertex_count * sizeof(size_t));
+    for (size_t i = 0; i < index_count; i++) adjacency[fill[indices[i]]++] = (uint)(i / 3);
+    free(fill);
+
+    size_t *timestamps = noh_realloc_check(NULL, (vertex_count + 1) * sizeof(size_t));
+    memset(timestamps, 0, vertex_count * sizeof(size_t));
+    bool *emitted = noh_realloc_check(NULL, triangle_count + 1);
+    memset(emitted, 0, triangle_count);
+    uint *candidates = noh_realloc_check(NULL, (index_count + 1) * sizeof(uint));
+    Vertex_Stack dead_ends = {0};
+
+    size_t time = cache_size + 1;
+    size_t cursor = 0;
+    size_t emitted_count = 0;
+    long fan = triangle_count > 0 ? (long)indices[0] : -1;
+    while (fan >= 0) {
+        size_t candidate_count = 0;
+        for (size_t a = offsets[fan]; a < offsets[fan + 1]; a++) {
+            uint t = adjacency[a];
+            if (emitted[t]) continue;
+
+            for (int k = 0; k < 3; k++) {
+                uint v = indices[3 * t + k];
+                noh_da_append(&dead_ends, v);
+                candidates[candidate_count++] = v;
+                live[v]--;
+                // Only vertices that are not in the cache anymore get loaded again.
+                if (time - timestamps[v] > cache_size) timestamps[v] = time++;
+            }
+            emitted[t] = true;
+            order[emitted_count++] = t;
+        }
+
+        fan = next_candidate(candidates, candidate_count, live, timestamps, time, cache_size);
+        if (fan < 0) fan = skip_dead_end(&dead_ends, live, vertex_count, &cursor);
+    }
+    noh_assert(emitted_count == triangle_count);
+
+    free(live);
+    free(offsets);
+    free(adjacency);
+    free(timestamps);
+    free(emitted);
+    free(candidates);
+    noh_da_free(&dead_ends);
+}
@@ -0,0 +1,31 @@
+#ifndef VCACHE_H_
+#define VCACHE_H_
+
+#include "noh.h"
+
+// Post-transform vertex cache simulation and optimization. The GPU caches the results of the vertex shader for the
+// last few vertex indexes, so index orders that reuse recent vertices need fewer vertex shader runs. This is measured
+// as the average cache miss ratio (ACMR): the number of cache misses per triangle.
+
+// How the simulated cache evicts vertices.
+typedef enum {
+    VCACHE_FIFO, // The oldest inserted vertex is evicted, hits don't refresh a vertex. This is how most GPUs work.
+    VCACHE_LRU, // The least recently used vertex is evicted.
+} Vcache_Policy;
+
+// Returns a readable name of a policy.
+const char *vcache_policy_name(Vcache_Policy policy);
+
+// Returns the ACMR of drawing the specified indexes with a cache of the specified size. Indexes are read either as a
+// triangle strip or as a triangle list. Triangles in a strip that repeat an index are not counted, since they are
+// never rasterized. Returns 0 if there are no triangles.
+double vcache_acmr(const uint *indices, size_t index_count, bool strip, Vcache_Policy policy, size_t cache_size);
+
+// Computes a triangle order for a triangle list that reduces the ACMR for a cache of the specified size, following
+// Tipsify (Sander, Nehab and Barczak, 2007): triangles are emitted as fans around a vertex, moving on to the vertex of
+// the last fan that has been in the cache the longest, among those whose remaining triangles can still be emitted
+// before it is evicted. Writes the triangle indexes in the new order to order, which needs room for index_count / 3
+// triangles. Triangles themselves are not changed.
+void vcache_tipsify(const uint *indices, size_t index_count, size_t vertex_count, size_t cache_size, uint *order);
+
+#endif // VCACHE_H_